@@ -0,0 +1,76 @@
+#pragma once
+
+#include "IProxyLogger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace proxy
+{
+
+/**
+ * @brief Formats each message on the thread logging it and hands it to another logger on a background thread,
+ *        so the engine never waits for the log I/O of the application. Messages go through a bounded ring
+ *        buffer without locks; when it is full they are dropped and counted instead of blocking.
+ */
+class PROXY_DISCOVERY_MODULE_API AsyncProxyLogger : public IProxyLogger
+{
+public:
+    /**
+     * @param logger receives the messages on the background thread, must outlive this logger
+     * @param capacity how many messages may wait, rounded up to a power of two
+     */
+    explicit AsyncProxyLogger(IProxyLogger& logger, size_t capacity = 1024);
+    /**
+     * @brief Hands the waiting messages to the logger before returning
+     */
+    ~AsyncProxyLogger();
+    AsyncProxyLogger(const AsyncProxyLogger&) = delete;
+    AsyncProxyLogger& operator = (const AsyncProxyLogger&) = delete;
+
+    void Log( int severity, const char* msgFormatter, ... ) override;
+    void Log( int severity, const char* msgFormatter, va_list args ) override;
+
+    /**
+     * @brief Waits until the messages logged before the call reached the logger
+     */
+    void flush();
+
+    /**
+     * @return How many messages were dropped because too many were waiting
+     */
+    size_t droppedCount() const;
+
+    //messages are cut to this length, terminating NUL included
+    static constexpr size_t maxMessageLength = 512;
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        int severity;
+        char message[maxMessageLength];
+    };
+
+    bool pop();
+    void run();
+
+    IProxyLogger& m_logger;
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> m_dequeuePos{ 0 };
+    std::atomic<size_t> m_dropped{ 0 };
+    std::atomic<bool> m_stopping{ false };
+
+    //only used to sleep and wake, never while a message is pushed
+    std::mutex m_mutex;
+    std::condition_variable m_pushed;
+    std::condition_variable m_drained;
+    std::thread m_thread;
+};
+
+} //namespace proxy
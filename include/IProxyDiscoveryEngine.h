@@ -3,16 +3,89 @@
 #include "ProxyRecord.h"
 #include "ProxyDef.h"
 
+#include <chrono>
+#include <functional>
+#include <future>
 #include <list>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 
 namespace proxy
 {
 
+/**
+ * @brief Why an asynchronous request ended without a proxy list
+ */
+enum class PROXY_DISCOVERY_MODULE_API ProxyRequestOutcome
+{
+    Cancelled,
+    TimedOut,
+    //the discovery threw, the error is logged
+    Failed
+};
+
+/**
+ * @brief The error of a future returned by IProxyDiscoveryEngine::requestProxies when the request was cancelled,
+ *        ran past its deadline or failed
+ */
+class PROXY_DISCOVERY_MODULE_API ProxyRequestAbortedError : public std::runtime_error
+{
+public:
+    explicit ProxyRequestAbortedError(ProxyRequestOutcome outcome) :
+        std::runtime_error(describe(outcome)),
+        m_outcome(outcome) {}
+
+    ProxyRequestOutcome outcome() const
+    {
+        return m_outcome;
+    }
+
+private:
+    static const char *describe(ProxyRequestOutcome outcome)
+    {
+        switch (outcome) {
+        case ProxyRequestOutcome::Cancelled:
+            return "proxy request cancelled";
+        case ProxyRequestOutcome::TimedOut:
+            return "proxy request timed out";
+        case ProxyRequestOutcome::Failed:
+            break;
+        }
+        return "proxy request failed";
+    }
+
+    ProxyRequestOutcome m_outcome;
+};
+
+/**
+ * @brief Completes one asynchronous request with its proxies, or with why it ended without them
+ */
+using ProxyRequestCallback = std::function<void(ProxyRecords proxies, std::optional<ProxyRequestOutcome> aborted)>;
+
 class IProxyObserver
 {
 public:
     virtual void updateProxyList(const std::list<ProxyRecord>& proxies, const std::string& guid) = 0;
+
+    /**
+     * @brief Called by the engine with the discovered proxies. The default copies them into a list for
+     *        updateProxyList, an observer overriding this receives them without copies.
+     */
+    virtual void updateProxies(const ProxyRecords& proxies, const std::string& guid)
+    {
+        updateProxyList(std::list<ProxyRecord>(proxies.begin(), proxies.end()), guid);
+    }
+
+    /**
+     * @brief Called instead of updateProxyList when a request was cancelled, ran past its deadline or failed.
+     *        The default reports an empty proxy list through updateProxyList.
+     */
+    virtual void proxyRequestAborted(const std::string& guid, ProxyRequestOutcome outcome)
+    {
+        (void)outcome;
+        updateProxyList({}, guid);
+    }
 };
 
 /**
@@ -22,9 +95,91 @@ class PROXY_DISCOVERY_MODULE_API IProxyDiscoveryEngine {
 public:
     virtual ~IProxyDiscoveryEngine() = default;
     virtual void addObserver(IProxyObserver& pObserver) = 0;
+
+    /**
+     * @brief Stops notifying an observer. Once this returns the observer is not being notified and can be destroyed.
+     */
+    virtual void removeObserver(IProxyObserver& pObserver) = 0;
+
     virtual void waitPrevOpCompleted() = 0;
     virtual void requestProxiesAsync(const std::string& testUrl, const std::string &pacUrl, const std::string& guid) = 0;
+
+    /**
+     * @brief Like requestProxiesAsync without a timeout, but the request is abandoned once the timeout has passed
+     *        and its observers get ProxyRequestOutcome::TimedOut. The default ignores the timeout.
+     */
+    virtual void requestProxiesAsync(const std::string& testUrl, const std::string &pacUrl, const std::string& guid,
+                                     std::chrono::milliseconds timeout)
+    {
+        (void)timeout;
+        requestProxiesAsync(testUrl, pacUrl, guid);
+    }
+
+    /**
+     * @brief Abandons the asynchronous requests made with guid, their observers get ProxyRequestOutcome::Cancelled.
+     *        The default does nothing.
+     */
+    virtual void cancel(const std::string& guid)
+    {
+        (void)guid;
+    }
+
+    /**
+     * @brief Discovers proxies for a single caller, the observers are not notified.
+     *        The default discovers on the calling thread and runs the callback before returning.
+     * @param guid identifies the request for cancel, may be empty
+     * @param timeout when the request is abandoned, none to let it run to the end
+     * @param callback called once with the result, on the thread that discovered the proxies
+     */
+    virtual void requestProxiesAsync(const std::string& testUrl, const std::string &pacUrl, const std::string& guid,
+                                     std::optional<std::chrono::milliseconds> timeout, ProxyRequestCallback callback)
+    {
+        (void)guid;
+        (void)timeout;
+        callback(getProxyRecords(testUrl, pacUrl), std::nullopt);
+    }
+
+    /**
+     * @brief Discovers proxies for a single caller, the observers are not notified
+     * @return The proxies, or a ProxyRequestAbortedError when the request was cancelled, timed out or failed
+     */
+    std::future<ProxyRecords> requestProxies(const std::string& testUrl, const std::string &pacUrl,
+                                                       const std::string& guid = "",
+                                                       std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+    {
+        auto promise = std::make_shared<std::promise<ProxyRecords>>();
+        std::future<ProxyRecords> result = promise->get_future();
+        requestProxiesAsync(testUrl, pacUrl, guid, timeout, [promise](ProxyRecords proxies, std::optional<ProxyRequestOutcome> aborted) {
+            if (aborted) {
+                promise->set_exception(std::make_exception_ptr(ProxyRequestAbortedError(*aborted)));
+            } else {
+                promise->set_value(std::move(proxies));
+            }
+        });
+        return result;
+    }
+
     virtual std::list<ProxyRecord> getProxies(const std::string& testUrl, const std::string &pacUrl) = 0;
+
+    /**
+     * @return The smoothed latency measured when the proxy was verified, none when it was not measured.
+     *         The default measures nothing.
+     */
+    virtual std::optional<ProxyLatency> proxyLatency(const ProxyRecord& proxy)
+    {
+        (void)proxy;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Like getProxies, the proxies are moved out of the engine in a contiguous sequence.
+     *        The default copies the result of getProxies.
+     */
+    virtual ProxyRecords getProxyRecords(const std::string& testUrl, const std::string &pacUrl)
+    {
+        const std::list<ProxyRecord> proxies = getProxies(testUrl, pacUrl);
+        return ProxyRecords(proxies.begin(), proxies.end());
+    }
 };
 
 std::shared_ptr<IProxyDiscoveryEngine>  PROXY_DISCOVERY_MODULE_API createProxyEngine();
@@ -17,4 +17,10 @@ public:
 IProxyLogger& GetProxyLogger();
 void PROXY_DISCOVERY_MODULE_API SetProxyLogger(IProxyLogger* logger);
 
+/**
+ * @brief Drops the messages less severe than severity before they are formatted, 7 (debug) lets all of them
+ *        through. Messages the build left out with PROXY_LOG_COMPILED_SEVERITY stay out.
+ */
+void PROXY_DISCOVERY_MODULE_API SetProxyLogSeverity(int severity);
+
 } //namespace proxy
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ProxyDef.h"
+
+#include <chrono>
+#include <initializer_list>
+#include <string_view>
+
+namespace proxy
+{
+
+/**
+ * @brief A name and value telling apart the series of one metric, e.g. result="hit"
+ */
+struct ProxyMetricLabel
+{
+    std::string_view name;
+    std::string_view value;
+};
+
+using ProxyMetricLabels = std::initializer_list<ProxyMetricLabel>;
+
+/**
+ * @brief Receives the measurements of the engine. Calls come from any thread and the names and labels only
+ *        live for the duration of the call.
+ */
+class IProxyMetrics
+{
+public:
+    virtual ~IProxyMetrics() {}
+    virtual void incrementCounter(std::string_view name, ProxyMetricLabels labels) = 0;
+    virtual void observeDuration(std::string_view name, ProxyMetricLabels labels, std::chrono::microseconds duration) = 0;
+};
+
+IProxyMetrics& GetProxyMetrics();
+void PROXY_DISCOVERY_MODULE_API SetProxyMetrics(IProxyMetrics* metrics);
+
+} //namespace proxy
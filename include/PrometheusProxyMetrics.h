@@ -0,0 +1,50 @@
+#pragma once
+
+#include "IProxyMetrics.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace proxy
+{
+
+/**
+ * @brief Keeps the measurements of the engine in memory and renders them in the Prometheus text format.
+ *        Durations go into histograms with buckets in seconds, counters keep counting until the object goes.
+ */
+class PROXY_DISCOVERY_MODULE_API PrometheusProxyMetrics : public IProxyMetrics
+{
+public:
+    /**
+     * @param buckets the upper bounds of the histogram buckets in seconds, ascending
+     */
+    explicit PrometheusProxyMetrics(std::vector<double> buckets = defaultBuckets());
+
+    void incrementCounter(std::string_view name, ProxyMetricLabels labels) override;
+    void observeDuration(std::string_view name, ProxyMetricLabels labels, std::chrono::microseconds duration) override;
+
+    /**
+     * @return Every metric measured so far, sorted by name and labels
+     */
+    std::string render() const;
+
+    static std::vector<double> defaultBuckets();
+
+private:
+    struct Histogram
+    {
+        std::vector<uint64_t> counts;
+        uint64_t count = 0;
+        double sum = 0;
+    };
+
+    std::vector<double> m_buckets;
+    mutable std::mutex m_mutex;
+    //by metric name, then by the rendered labels
+    std::map<std::string, std::map<std::string, uint64_t>, std::less<>> m_counters;
+    std::map<std::string, std::map<std::string, Histogram>, std::less<>> m_histograms;
+};
+
+} //namespace proxy
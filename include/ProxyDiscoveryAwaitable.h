@@ -0,0 +1,79 @@
+#pragma once
+
+#include "IProxyDiscoveryEngine.h"
+
+#if !defined(PROXY_DISCOVERY_COROUTINES)
+#error "ProxyDiscoveryAwaitable.h needs the library built with -DPROXY_DISCOVERY_COROUTINES=ON"
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <string>
+
+namespace proxy
+{
+
+/**
+ * @brief Awaits one asynchronous proxy request, so a coroutine waits for discovery without holding a thread.
+ *        The coroutine resumes on the thread that discovered the proxies. co_await throws a ProxyRequestAbortedError
+ *        when the request was cancelled or timed out.
+ */
+class ProxiesAwaitable
+{
+public:
+    ProxiesAwaitable(IProxyDiscoveryEngine& engine, std::string testUrl, std::string pacUrl, std::string guid,
+                     std::optional<std::chrono::milliseconds> timeout) :
+        m_engine(engine), m_testUrl(std::move(testUrl)), m_pacUrl(std::move(pacUrl)), m_guid(std::move(guid)),
+        m_timeout(timeout) {}
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        m_awaiting = awaiting;
+        m_engine.requestProxiesAsync(m_testUrl, m_pacUrl, m_guid, m_timeout,
+            [this](ProxyRecords proxies, std::optional<ProxyRequestOutcome> aborted) {
+                m_proxies = std::move(proxies);
+                m_aborted = aborted;
+                //whichever of the callback and await_suspend finishes second continues the coroutine
+                if (m_finished.exchange(true)) {
+                    m_awaiting.resume();
+                }
+            });
+        return !m_finished.exchange(true);
+    }
+
+    ProxyRecords await_resume()
+    {
+        if (m_aborted) {
+            throw ProxyRequestAbortedError(*m_aborted);
+        }
+        return std::move(m_proxies);
+    }
+
+private:
+    IProxyDiscoveryEngine& m_engine;
+    std::string m_testUrl;
+    std::string m_pacUrl;
+    std::string m_guid;
+    std::optional<std::chrono::milliseconds> m_timeout;
+    ProxyRecords m_proxies;
+    std::optional<ProxyRequestOutcome> m_aborted;
+    std::coroutine_handle<> m_awaiting;
+    std::atomic<bool> m_finished{ false };
+};
+
+/**
+ * @return An awaitable for the proxies of one request, the observers are not notified
+ */
+inline ProxiesAwaitable discoverProxies(IProxyDiscoveryEngine& engine, std::string testUrl, std::string pacUrl,
+                                        std::string guid = "", std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+{
+    return ProxiesAwaitable(engine, std::move(testUrl), std::move(pacUrl), std::move(guid), timeout);
+}
+
+} //proxy
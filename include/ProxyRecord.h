@@ -1,8 +1,11 @@
 #pragma once
 
 #include "ProxyDef.h"
+#include "SmallVector.h"
+#include <array>
+#include <chrono>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <cstdint>
 
 namespace proxy
@@ -19,6 +22,24 @@ enum class PROXY_DISCOVERY_MODULE_API ProxyTypes
     None
 };
 
+/**
+ * @return The name of a proxy type, empty for ProxyTypes::None or a value outside the enum
+ */
+constexpr std::string_view proxyTypeName(ProxyTypes type)
+{
+    constexpr std::array<std::string_view, static_cast<std::size_t>(ProxyTypes::None) + 1> names{
+        "autoConfigurationURL",
+        "autoConfigurationJavaScript",
+        "ftp",
+        "http",
+        "https",
+        "socks",
+        ""
+    };
+    const auto index = static_cast<std::size_t>(type);
+    return index < names.size() ? names[index] : std::string_view{};
+}
+
 struct ProxyTypesHasher
 {
     template <typename T>
@@ -45,9 +66,29 @@ struct PROXY_DISCOVERY_MODULE_API ProxyRecord
         return !( *this == rhs );
     }
     
-    std::string getProxyTypeName() const;
-    
-private:
-    static std::unordered_map<ProxyTypes, std::string, ProxyTypesHasher> s_proxyTypeToName;
+    std::string getProxyTypeName() const
+    {
+        return std::string(proxyTypeName(proxyType));
+    }
 };
+
+/**
+ * @brief How quickly a proxy answered its verifications, each phase smoothed over the verifications measured
+ */
+struct PROXY_DISCOVERY_MODULE_API ProxyLatency
+{
+    //until the TCP connection to the proxy was up
+    std::chrono::microseconds connect{ 0 };
+    //until the proxy handshake, tunnel or TLS session was done, zero when the verification did not need one
+    std::chrono::microseconds handshake{ 0 };
+    //until the first byte of the response, zero when the verification did not wait for one
+    std::chrono::microseconds firstByte{ 0 };
+    //what proxies are ranked by: the last phase each verification reached
+    std::chrono::microseconds score{ 0 };
+};
+
+/**
+ * @brief Discovered proxies, kept in place for the usual handful of records
+ */
+using ProxyRecords = SmallVector<ProxyRecord, 8>;
 } //proxy namespace
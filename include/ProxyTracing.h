@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ProxyDef.h"
+
+#include <string>
+
+namespace proxy
+{
+
+/**
+ * @brief Starts recording what the engine does as spans tagged with the guid of the request they belong to,
+ *        discarding the spans of an earlier trace. Nothing is recorded until this is called.
+ */
+void PROXY_DISCOVERY_MODULE_API StartProxyTrace();
+
+/**
+ * @brief Stops recording spans, the spans recorded so far stay available to ExportProxyTrace
+ */
+void PROXY_DISCOVERY_MODULE_API StopProxyTrace();
+
+/**
+ * @return The spans of the current or last trace in the Chrome trace-event JSON format, which chrome://tracing
+ *         and Perfetto load. Spans still open are left out.
+ */
+std::string PROXY_DISCOVERY_MODULE_API ExportProxyTrace();
+
+} //namespace proxy
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace proxy
+{
+
+/**
+ * @brief A contiguous sequence which keeps up to N elements in place and only allocates beyond that
+ */
+template <typename T, std::size_t N>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector needs room for at least one element in place");
+    static_assert(std::is_nothrow_move_constructible<T>::value, "SmallVector moves elements when it grows");
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "SmallVector allocates with operator new");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() noexcept : m_data(inlineData()) {}
+
+    SmallVector(std::initializer_list<T> values) : SmallVector(values.begin(), values.end()) {}
+
+    template <typename InputIt,
+              typename = std::enable_if_t<std::is_base_of<std::input_iterator_tag,
+                                                          typename std::iterator_traits<InputIt>::iterator_category>::value>>
+    SmallVector(InputIt first, InputIt last) : SmallVector()
+    {
+        append(first, last);
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector()
+    {
+        append(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept : SmallVector()
+    {
+        take(other);
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        releaseHeap();
+    }
+
+    SmallVector& operator =(const SmallVector& other)
+    {
+        if (this != &other) {
+            clear();
+            append(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator =(SmallVector&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            releaseHeap();
+            take(other);
+        }
+        return *this;
+    }
+
+    iterator begin() noexcept { return m_data; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator cbegin() const noexcept { return m_data; }
+    iterator end() noexcept { return m_data + m_size; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+    const_iterator cend() const noexcept { return m_data + m_size; }
+
+    pointer data() noexcept { return m_data; }
+    const_pointer data() const noexcept { return m_data; }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    /**
+     * @return Whether the elements are kept in place, i.e. the sequence never allocated
+     */
+    bool isInline() const noexcept { return m_data == inlineData(); }
+
+    reference operator [](size_type index) { return m_data[index]; }
+    const_reference operator [](size_type index) const { return m_data[index]; }
+    reference front() { return m_data[0]; }
+    const_reference front() const { return m_data[0]; }
+    reference back() { return m_data[m_size - 1]; }
+    const_reference back() const { return m_data[m_size - 1]; }
+
+    void reserve(size_type capacity)
+    {
+        if (capacity > m_capacity) {
+            T* data = allocate(capacity);
+            relocate(data);
+            m_capacity = capacity;
+        }
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size < m_capacity) {
+            ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+            return m_data[m_size++];
+        }
+
+        //the new element is built before the old ones move, args may refer to one of them
+        const size_type capacity = m_capacity * 2;
+        T* data = allocate(capacity);
+        try {
+            ::new (static_cast<void*>(data + m_size)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            ::operator delete(data);
+            throw;
+        }
+        relocate(data);
+        m_capacity = capacity;
+        return m_data[m_size++];
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back()
+    {
+        m_data[--m_size].~T();
+    }
+
+    /**
+     * @brief Appends the elements of [first, last), which must not be elements of this sequence
+     */
+    template <typename InputIt>
+    void append(InputIt first, InputIt last)
+    {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+            reserve(m_size + static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    iterator erase(const_iterator position)
+    {
+        return erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator from = m_data + (first - m_data);
+        iterator to = m_data + (last - m_data);
+        if (from != to) {
+            iterator newEnd = std::move(to, end(), from);
+            std::destroy(newEnd, end());
+            m_size = static_cast<size_type>(newEnd - m_data);
+        }
+        return from;
+    }
+
+    void clear() noexcept
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    bool operator ==(const SmallVector& rhs) const
+    {
+        return std::equal(begin(), end(), rhs.begin(), rhs.end());
+    }
+
+    bool operator !=(const SmallVector& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    T* inlineData() noexcept
+    {
+        return std::launder(reinterpret_cast<T*>(m_inline));
+    }
+
+    const T* inlineData() const noexcept
+    {
+        return std::launder(reinterpret_cast<const T*>(m_inline));
+    }
+
+    static T* allocate(size_type capacity)
+    {
+        return static_cast<T*>(::operator new(capacity * sizeof(T)));
+    }
+
+    //moves the elements to data, which becomes the storage
+    void relocate(T* data) noexcept
+    {
+        std::uninitialized_move(begin(), end(), data);
+        std::destroy(begin(), end());
+        releaseHeap();
+        m_data = data;
+    }
+
+    void releaseHeap() noexcept
+    {
+        if (!isInline()) {
+            ::operator delete(m_data);
+            m_data = inlineData();
+            m_capacity = N;
+        }
+    }
+
+    //expects this to be empty and in place
+    void take(SmallVector& other) noexcept
+    {
+        if (other.isInline()) {
+            std::uninitialized_move(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+            other.clear();
+            return;
+        }
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_data = other.inlineData();
+        other.m_size = 0;
+        other.m_capacity = N;
+    }
+
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T* m_data;
+    size_type m_size = 0;
+    size_type m_capacity = N;
+};
+
+} //proxy
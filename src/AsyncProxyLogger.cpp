@@ -0,0 +1,129 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "AsyncProxyLogger.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace proxy {
+
+//a push that races the background thread going to sleep is picked up after this long at the latest
+static constexpr std::chrono::milliseconds s_idlePoll{ 10 };
+
+static size_t _power_of_two(size_t capacity)
+{
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+AsyncProxyLogger::AsyncProxyLogger(IProxyLogger& logger, size_t capacity) :
+    m_logger(logger)
+{
+    const size_t slots = _power_of_two(capacity);
+    m_slots = std::make_unique<Slot[]>(slots);
+    m_mask = slots - 1;
+    for (size_t i = 0; i < slots; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_thread = std::thread(&AsyncProxyLogger::run, this);
+}
+
+AsyncProxyLogger::~AsyncProxyLogger()
+{
+    m_stopping.store(true);
+    m_pushed.notify_all();
+    m_thread.join();
+}
+
+void AsyncProxyLogger::Log( int severity, const char* msgFormatter, ... )
+{
+    va_list args;
+    va_start(args, msgFormatter);
+    Log(severity, msgFormatter, args);
+    va_end(args);
+}
+
+void AsyncProxyLogger::Log( int severity, const char* msgFormatter, va_list args )
+{
+    //claims a slot, the sequence of a slot tells whether its previous message was taken yet
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    for (;;) {
+        slot = &m_slots[pos & m_mask];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (difference == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->severity = severity;
+    std::vsnprintf(slot->message, sizeof(slot->message), msgFormatter, args);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    m_pushed.notify_one();
+}
+
+void AsyncProxyLogger::flush()
+{
+    const size_t logged = m_enqueuePos.load();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_dequeuePos.load() < logged) {
+        m_drained.wait_for(lock, s_idlePoll);
+    }
+}
+
+size_t AsyncProxyLogger::droppedCount() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+//called on the background thread only
+bool AsyncProxyLogger::pop()
+{
+    const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Slot &slot = m_slots[pos & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+    m_logger.Log(slot.severity, "%s", slot.message);
+    //frees the slot for the push one lap later
+    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_dequeuePos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void AsyncProxyLogger::run()
+{
+    for (;;) {
+        while (pop()) {
+        }
+        m_drained.notify_all();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stopping.load()) {
+            lock.unlock();
+            //whatever was logged before the destructor ran still reaches the logger
+            while (pop()) {
+            }
+            m_drained.notify_all();
+            return;
+        }
+        m_pushed.wait_for(lock, s_idlePoll);
+    }
+}
+
+} //namespace proxy
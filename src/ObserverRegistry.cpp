@@ -0,0 +1,92 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "ObserverRegistry.hpp"
+
+#include <algorithm>
+
+namespace proxy {
+
+ObserverRegistry::ObserverRegistry() :
+    m_snapshot(std::make_shared<const Snapshot>())
+{
+}
+
+void ObserverRegistry::add(IProxyObserver& observer)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    const auto current = snapshot();
+    const bool present = std::any_of(current->begin(), current->end(),
+        [&observer](const auto& entry) { return &entry->observer == &observer; });
+    if (present) {
+        return;
+    }
+    auto next = std::make_shared<Snapshot>(*current);
+    next->push_back(std::make_shared<Entry>(observer));
+    replaceSnapshot(std::move(next));
+}
+
+void ObserverRegistry::remove(IProxyObserver& observer)
+{
+    std::shared_ptr<Entry> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        const auto current = snapshot();
+        auto next = std::make_shared<Snapshot>();
+        next->reserve(current->size());
+        for (const auto& entry : *current) {
+            if (&entry->observer == &observer) {
+                removed = entry;
+            } else {
+                next->push_back(entry);
+            }
+        }
+        if (!removed) {
+            return;
+        }
+        replaceSnapshot(std::move(next));
+    }
+
+    //notifications that took the old snapshot may still reach the entry, wait out a running one
+    std::lock_guard<std::recursive_mutex> lock(removed->notifying);
+    removed->removed = true;
+}
+
+void ObserverRegistry::notify(const std::function<void(IProxyObserver&)>& notify) const
+{
+    const auto current = snapshot();
+    for (const auto& entry : *current) {
+        std::lock_guard<std::recursive_mutex> lock(entry->notifying);
+        if (!entry->removed) {
+            notify(entry->observer);
+        }
+    }
+}
+
+size_t ObserverRegistry::size() const
+{
+    return snapshot()->size();
+}
+
+std::shared_ptr<const ObserverRegistry::Snapshot> ObserverRegistry::snapshot() const
+{
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return m_snapshot.load();
+#else
+    return std::atomic_load(&m_snapshot);
+#endif
+}
+
+void ObserverRegistry::replaceSnapshot(std::shared_ptr<const Snapshot> snapshot)
+{
+#if defined(__cpp_lib_atomic_shared_ptr)
+    m_snapshot.store(std::move(snapshot));
+#else
+    std::atomic_store(&m_snapshot, std::move(snapshot));
+#endif
+}
+
+} //proxy
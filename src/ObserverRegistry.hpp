@@ -0,0 +1,71 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IProxyDiscoveryEngine.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief The observers of an engine. Notifying reads an immutable snapshot of the observer list without locking
+ *        the registry, adding and removing replace the snapshot.
+ */
+class ObserverRegistry
+{
+public:
+    ObserverRegistry();
+
+    /**
+     * @brief Adds an observer, an observer already added is not added twice
+     */
+    void add(IProxyObserver& observer);
+
+    /**
+     * @brief Removes an observer. Once this returns the observer is not being notified and will not be again,
+     *        unless the call comes from the observer's own notification.
+     */
+    void remove(IProxyObserver& observer);
+
+    /**
+     * @brief Calls notify for every observer registered when the call starts. Notifications of one observer
+     *        do not overlap.
+     */
+    void notify(const std::function<void(IProxyObserver&)>& notify) const;
+
+    size_t size() const;
+
+private:
+    struct Entry
+    {
+        explicit Entry(IProxyObserver& observer) : observer(observer) {}
+
+        IProxyObserver& observer;
+        //held while the observer is notified, recursive so an observer can remove itself
+        std::recursive_mutex notifying;
+        bool removed = false;
+    };
+    using Snapshot = std::vector<std::shared_ptr<Entry>>;
+
+    std::shared_ptr<const Snapshot> snapshot() const;
+    void replaceSnapshot(std::shared_ptr<const Snapshot> snapshot);
+
+    std::mutex m_writeMutex;
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const Snapshot>> m_snapshot;
+#else
+    //read with std::atomic_load, replaced with std::atomic_store, both deprecated once atomic<shared_ptr> exists
+    std::shared_ptr<const Snapshot> m_snapshot;
+#endif
+};
+
+} //proxy
@@ -0,0 +1,131 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "PrometheusProxyMetrics.h"
+
+#include <algorithm>
+#include <locale>
+#include <sstream>
+
+namespace proxy {
+
+//name="value" pairs joined by commas, the values escaped as the text format requires
+static std::string _render_labels(ProxyMetricLabels labels)
+{
+    std::string rendered;
+    for (const auto &label : labels) {
+        if (!rendered.empty()) {
+            rendered.push_back(',');
+        }
+        rendered.append(label.name).append("=\"");
+        for (const char c : label.value) {
+            if (c == '\\' || c == '"') {
+                rendered.push_back('\\');
+                rendered.push_back(c);
+            } else if (c == '\n') {
+                rendered.append("\\n");
+            } else {
+                rendered.push_back(c);
+            }
+        }
+        rendered.push_back('"');
+    }
+    return rendered;
+}
+
+static std::string _series(const std::string &name, const std::string &labels, const std::string &extraLabel = {})
+{
+    std::string series = name;
+    if (!labels.empty() || !extraLabel.empty()) {
+        series.push_back('{');
+        series.append(labels);
+        if (!labels.empty() && !extraLabel.empty()) {
+            series.push_back(',');
+        }
+        series.append(extraLabel);
+        series.push_back('}');
+    }
+    return series;
+}
+
+PrometheusProxyMetrics::PrometheusProxyMetrics(std::vector<double> buckets) :
+    m_buckets(std::move(buckets))
+{
+    std::sort(m_buckets.begin(), m_buckets.end());
+    m_buckets.erase(std::unique(m_buckets.begin(), m_buckets.end()), m_buckets.end());
+}
+
+std::vector<double> PrometheusProxyMetrics::defaultBuckets()
+{
+    return { 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30 };
+}
+
+void PrometheusProxyMetrics::incrementCounter(std::string_view name, ProxyMetricLabels labels)
+{
+    std::string rendered = _render_labels(labels);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto metric = m_counters.find(name);
+    if (metric == m_counters.end()) {
+        metric = m_counters.emplace(std::string(name), std::map<std::string, uint64_t>{}).first;
+    }
+    ++metric->second[std::move(rendered)];
+}
+
+void PrometheusProxyMetrics::observeDuration(std::string_view name, ProxyMetricLabels labels, std::chrono::microseconds duration)
+{
+    std::string rendered = _render_labels(labels);
+    const double seconds = std::chrono::duration<double>(duration).count();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto metric = m_histograms.find(name);
+    if (metric == m_histograms.end()) {
+        metric = m_histograms.emplace(std::string(name), std::map<std::string, Histogram>{}).first;
+    }
+    Histogram &histogram = metric->second[std::move(rendered)];
+    if (histogram.counts.empty()) {
+        histogram.counts.resize(m_buckets.size());
+    }
+    //each bucket counts only its own range here, render adds up the smaller ones
+    const auto bucket = std::lower_bound(m_buckets.begin(), m_buckets.end(), seconds);
+    if (bucket != m_buckets.end()) {
+        ++histogram.counts[static_cast<size_t>(bucket - m_buckets.begin())];
+    }
+    ++histogram.count;
+    histogram.sum += seconds;
+}
+
+std::string PrometheusProxyMetrics::render() const
+{
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.precision(10);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &metric : m_counters) {
+        out << "# TYPE " << metric.first << " counter\n";
+        for (const auto &series : metric.second) {
+            out << _series(metric.first, series.first) << " " << series.second << "\n";
+        }
+    }
+    for (const auto &metric : m_histograms) {
+        out << "# TYPE " << metric.first << " histogram\n";
+        for (const auto &series : metric.second) {
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < m_buckets.size(); ++i) {
+                cumulative += series.second.counts[i];
+                std::ostringstream bound;
+                bound.imbue(std::locale::classic());
+                bound << "le=\"" << m_buckets[i] << "\"";
+                out << _series(metric.first + "_bucket", series.first, bound.str()) << " " << cumulative << "\n";
+            }
+            out << _series(metric.first + "_bucket", series.first, "le=\"+Inf\"") << " " << series.second.count << "\n";
+            out << _series(metric.first + "_sum", series.first) << " " << series.second.sum << "\n";
+            out << _series(metric.first + "_count", series.first) << " " << series.second.count << "\n";
+        }
+    }
+    return out.str();
+}
+
+} //namespace proxy
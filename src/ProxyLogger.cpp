@@ -5,6 +5,7 @@
  */
 
 #include "IProxyLogger.h"
+#include "ProxyLoggerDef.hpp"
 
 namespace {
     class DefaultProxyLogger: public proxy::IProxyLogger
@@ -20,6 +21,8 @@ namespace {
 
 namespace proxy {
 
+std::atomic<int> g_proxyLogSeverity{ 7 };
+
 IProxyLogger& GetProxyLogger()
 {
     return g_proxyLogger ? *g_proxyLogger : g_defaultLogger;
@@ -30,4 +33,9 @@ void PROXY_DISCOVERY_MODULE_API SetProxyLogger(IProxyLogger* logger)
     g_proxyLogger = logger;
 }
 
+void PROXY_DISCOVERY_MODULE_API SetProxyLogSeverity(int severity)
+{
+    g_proxyLogSeverity.store(severity, std::memory_order_relaxed);
+}
+
 } //namespace proxy
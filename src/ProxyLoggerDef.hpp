@@ -2,29 +2,63 @@
 
 #include "IProxyLogger.h"
 
-#include <filesystem>
-#include <string>
+#include <atomic>
+
+//the least severe messages compiled in, e.g. 4 leaves the notice, info and debug messages out of the build
+#ifndef PROXY_LOG_COMPILED_SEVERITY
+#  define PROXY_LOG_COMPILED_SEVERITY 7
+#endif
+
+namespace proxy {
+
+//set by SetProxyLogSeverity, read without ordering by every message
+extern std::atomic<int> g_proxyLogSeverity;
+
+//the part of path after its last slash, without the allocation of std::filesystem::path
+constexpr const char* proxyLogFileName(const char* path)
+{
+    const char* name = path;
+    for (const char* c = path; *c; ++c) {
+        if (*c == '/' || *c == '\\') {
+            name = c + 1;
+        }
+    }
+    return name;
+}
+
+} //namespace proxy
 
 #if defined(__FILE_NAME__)
 #  define __FILENAME__ __FILE_NAME__
 #else
-#  define __FILENAME__ std::filesystem::path(__FILE__).filename().string().c_str()
+#  define __FILENAME__ proxy::proxyLogFileName(__FILE__)
 #endif
 
 #ifndef __FUNCTION__
 #   define __FUNCTION__ __func__
 #endif
 
-#define PROXY_LOG_ALERT( fmt, ... ) proxy::GetProxyLogger().Log( 1, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ )
+//checked before the arguments are evaluated, a message below the compiled severity costs nothing at all
+#define PROXY_LOG_ENABLED( severity ) \
+    ( (severity) <= PROXY_LOG_COMPILED_SEVERITY && (severity) <= proxy::g_proxyLogSeverity.load(std::memory_order_relaxed) )
+
+#define PROXY_LOG( severity, fmt, ... ) \
+    do { \
+        if (PROXY_LOG_ENABLED(severity)) { \
+            proxy::GetProxyLogger().Log( severity, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ ); \
+        } \
+    } while (0)
+
+#define PROXY_LOG_ALERT( fmt, ... ) PROXY_LOG( 1, fmt, ##__VA_ARGS__ )
 
-#define PROXY_LOG_CRITICAL( fmt, ... ) proxy::GetProxyLogger().Log( 2, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ )
+#define PROXY_LOG_CRITICAL( fmt, ... ) PROXY_LOG( 2, fmt, ##__VA_ARGS__ )
 
-#define PROXY_LOG_ERROR( fmt, ... ) proxy::GetProxyLogger().Log( 3, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ )
+#define PROXY_LOG_ERROR( fmt, ... ) PROXY_LOG( 3, fmt, ##__VA_ARGS__ )
 
-#define PROXY_LOG_WARNING( fmt, ... ) proxy::GetProxyLogger().Log( 4, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ )
+#define PROXY_LOG_WARNING( fmt, ... ) PROXY_LOG( 4, fmt, ##__VA_ARGS__ )
 
-#define PROXY_LOG_NOTICE( fmt, ... ) proxy::GetProxyLogger().Log( 5, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ )
+#define PROXY_LOG_NOTICE( fmt, ... ) PROXY_LOG( 5, fmt, ##__VA_ARGS__ )
 
-#define PROXY_LOG_INFO( fmt, ... ) proxy::GetProxyLogger().Log( 6, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ )
+#define PROXY_LOG_INFO( fmt, ... ) PROXY_LOG( 6, fmt, ##__VA_ARGS__ )
 
-#define PROXY_LOG_DEBUG( fmt, ... ) proxy::GetProxyLogger().Log( 7, "%s:%s:%d: " fmt, __FILENAME__, __FUNCTION__, __LINE__, ##__VA_ARGS__ )
+#define PROXY_LOG_DEBUG( fmt, ... ) PROXY_LOG( 7, fmt, ##__VA_ARGS__ )
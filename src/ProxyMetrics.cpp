@@ -0,0 +1,33 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "IProxyMetrics.h"
+
+namespace {
+    class DefaultProxyMetrics: public proxy::IProxyMetrics
+    {
+    public:
+        void incrementCounter(std::string_view /*name*/, proxy::ProxyMetricLabels /*labels*/) override {}
+        void observeDuration(std::string_view /*name*/, proxy::ProxyMetricLabels /*labels*/, std::chrono::microseconds /*duration*/) override {}
+    };
+
+    DefaultProxyMetrics g_defaultMetrics;
+    proxy::IProxyMetrics* g_proxyMetrics;
+}
+
+namespace proxy {
+
+IProxyMetrics& GetProxyMetrics()
+{
+    return g_proxyMetrics ? *g_proxyMetrics : g_defaultMetrics;
+}
+
+void PROXY_DISCOVERY_MODULE_API SetProxyMetrics(IProxyMetrics* metrics)
+{
+    g_proxyMetrics = metrics;
+}
+
+} //namespace proxy
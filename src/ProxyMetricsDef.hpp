@@ -0,0 +1,66 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IProxyMetrics.h"
+
+#include <chrono>
+#include <string>
+
+namespace proxy {
+
+//reading the proxy settings of the desktop and the environment
+constexpr std::string_view PROXY_METRIC_ENVIRONMENT_SCAN = "proxy_discovery_environment_scan_seconds";
+//each helper command run, labelled with the command
+constexpr std::string_view PROXY_METRIC_COMMAND = "proxy_discovery_command_seconds";
+//each proxy verification, labelled with the curl result code or why no transfer finished
+constexpr std::string_view PROXY_METRIC_VERIFICATIONS = "proxy_discovery_verifications_total";
+//the transfer of each proxy verification that finished
+constexpr std::string_view PROXY_METRIC_VERIFICATION = "proxy_discovery_verification_seconds";
+//each lookup of a cache, labelled with the cache and whether it was a hit or a miss
+constexpr std::string_view PROXY_METRIC_CACHE_LOOKUPS = "proxy_discovery_cache_lookups_total";
+//each discovery from the call or the queueing to the proxies, labelled sync or async
+constexpr std::string_view PROXY_METRIC_REQUEST = "proxy_discovery_request_seconds";
+
+inline void countCacheLookup(std::string_view cache, bool hit)
+{
+    GetProxyMetrics().incrementCounter(PROXY_METRIC_CACHE_LOOKUPS, { { "cache", cache }, { "result", hit ? "hit" : "miss" } });
+}
+
+inline std::chrono::microseconds elapsedSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * @brief Reports how long the scope it lives in took, also when the scope is left by an exception
+ */
+class ScopedMetricTimer
+{
+public:
+    explicit ScopedMetricTimer(std::string_view name, std::string_view labelName = {}, std::string labelValue = {}) :
+        m_name(name), m_labelName(labelName), m_labelValue(std::move(labelValue)),
+        m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedMetricTimer()
+    {
+        if (m_labelName.empty()) {
+            GetProxyMetrics().observeDuration(m_name, {}, elapsedSince(m_start));
+        } else {
+            GetProxyMetrics().observeDuration(m_name, { { m_labelName, m_labelValue } }, elapsedSince(m_start));
+        }
+    }
+    ScopedMetricTimer(const ScopedMetricTimer&) = delete;
+    ScopedMetricTimer& operator = (const ScopedMetricTimer&) = delete;
+
+private:
+    std::string_view m_name;
+    std::string_view m_labelName;
+    std::string m_labelValue;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} //proxy
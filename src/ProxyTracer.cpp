@@ -0,0 +1,256 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "ProxyTracer.hpp"
+#include "ProxyLoggerDef.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+
+namespace proxy {
+
+std::atomic<bool> g_proxyTracing{ false };
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    int64_t start;
+    int64_t duration;
+    uint64_t asyncId;
+    char detail[80];
+    char guid[48];
+};
+
+//events are kept in chunks allocated as a thread records them, a thread records at most 16K spans per trace
+constexpr size_t s_chunkSize = 1024;
+constexpr size_t s_maxChunks = 16;
+
+//written only by its thread, read by ExportProxyTrace without stopping the writer
+struct ThreadBuffer
+{
+    ~ThreadBuffer()
+    {
+        for (auto &chunk : chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t tid = 0;
+    std::atomic<bool> alive{ true };
+    //the trace the events belong to, the writer starts over when a new trace began
+    std::atomic<uint64_t> trace{ 0 };
+    std::atomic<size_t> count{ 0 };
+    std::atomic<TraceEvent*> chunks[s_maxChunks] = {};
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint64_t nextTid = 1;
+};
+
+//marks the buffer of a finished thread, its spans stay exportable until the next trace starts
+struct ThreadBufferOwner
+{
+    ~ThreadBufferOwner()
+    {
+        if (buffer) {
+            buffer->alive.store(false, std::memory_order_relaxed);
+        }
+    }
+    std::shared_ptr<ThreadBuffer> buffer;
+};
+
+std::atomic<uint64_t> g_traceNumber{ 0 };
+std::atomic<uint64_t> g_droppedSpans{ 0 };
+std::atomic<uint64_t> g_nextTraceId{ 1 };
+thread_local ThreadBufferOwner t_buffer;
+thread_local const std::string *t_requestGuid = nullptr;
+
+Registry &_registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+ThreadBuffer &_thread_buffer()
+{
+    if (!t_buffer.buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        Registry &registry = _registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer->tid = registry.nextTid++;
+        registry.buffers.push_back(buffer);
+        t_buffer.buffer = std::move(buffer);
+    }
+    return *t_buffer.buffer;
+}
+
+template<size_t N>
+void _copy_truncated(char (&to)[N], std::string_view from)
+{
+    const size_t length = std::min(from.size(), N - 1);
+    std::copy_n(from.data(), length, to);
+    to[length] = '\0';
+}
+
+int64_t _microseconds(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+void _append_json_string(std::string &out, const char *value)
+{
+    out.push_back('"');
+    for (const char *c = value; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out.push_back('\\');
+            out.push_back(*c);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*c));
+            out.append(escaped);
+        } else {
+            out.push_back(*c);
+        }
+    }
+    out.push_back('"');
+}
+
+void _append_event(std::string &out, const TraceEvent &event, uint64_t tid, const char *phase, int64_t timestamp)
+{
+    static const std::string pid = std::to_string(getpid());
+    if (out.back() != '[') {
+        out.append(",\n");
+    }
+    out.append("{\"name\":");
+    _append_json_string(out, event.name);
+    out.append(",\"cat\":\"proxy\",\"ph\":\"").append(phase).append("\",\"ts\":").append(std::to_string(timestamp));
+    if (event.asyncId == 0) {
+        out.append(",\"dur\":").append(std::to_string(event.duration));
+    } else {
+        out.append(",\"id\":").append(std::to_string(event.asyncId));
+    }
+    out.append(",\"pid\":").append(pid).append(",\"tid\":").append(std::to_string(tid));
+    out.append(",\"args\":{\"guid\":");
+    _append_json_string(out, event.guid);
+    out.append(",\"detail\":");
+    _append_json_string(out, event.detail);
+    out.append("}}");
+}
+
+} //namespace
+
+void recordTraceSpan(const char *name, std::string_view detail, std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end, uint64_t asyncId)
+{
+    if (!tracingEnabled()) {
+        return;
+    }
+    ThreadBuffer &buffer = _thread_buffer();
+    const uint64_t trace = g_traceNumber.load(std::memory_order_acquire);
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (buffer.trace.load(std::memory_order_relaxed) != trace) {
+        //emptied before it is marked as part of the new trace, so an export never mixes in the old events
+        buffer.count.store(0, std::memory_order_release);
+        buffer.trace.store(trace, std::memory_order_release);
+        index = 0;
+    }
+
+    const size_t chunk = index / s_chunkSize;
+    if (chunk >= s_maxChunks) {
+        g_droppedSpans.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent *events = buffer.chunks[chunk].load(std::memory_order_relaxed);
+    if (!events) {
+        events = new TraceEvent[s_chunkSize];
+        buffer.chunks[chunk].store(events, std::memory_order_release);
+    }
+
+    TraceEvent &event = events[index % s_chunkSize];
+    event.name = name;
+    event.start = _microseconds(start);
+    event.duration = std::max<int64_t>(_microseconds(end) - event.start, 0);
+    event.asyncId = asyncId;
+    _copy_truncated(event.detail, detail);
+    _copy_truncated(event.guid, t_requestGuid ? std::string_view(*t_requestGuid) : std::string_view());
+    //publishes the event to ExportProxyTrace
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+uint64_t nextTraceId()
+{
+    return g_nextTraceId.fetch_add(1, std::memory_order_relaxed);
+}
+
+TraceRequestScope::TraceRequestScope(const std::string &guid) :
+    m_previous(t_requestGuid)
+{
+    t_requestGuid = &guid;
+}
+
+TraceRequestScope::~TraceRequestScope()
+{
+    t_requestGuid = m_previous;
+}
+
+void PROXY_DISCOVERY_MODULE_API StartProxyTrace()
+{
+    Registry &registry = _registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    //the spans of finished threads belong to the earlier trace
+    registry.buffers.erase(std::remove_if(registry.buffers.begin(), registry.buffers.end(),
+        [](const auto &buffer) { return !buffer->alive.load(std::memory_order_relaxed); }), registry.buffers.end());
+    g_traceNumber.fetch_add(1, std::memory_order_release);
+    g_droppedSpans.store(0, std::memory_order_relaxed);
+    g_proxyTracing.store(true, std::memory_order_relaxed);
+}
+
+void PROXY_DISCOVERY_MODULE_API StopProxyTrace()
+{
+    g_proxyTracing.store(false, std::memory_order_relaxed);
+}
+
+std::string PROXY_DISCOVERY_MODULE_API ExportProxyTrace()
+{
+    std::string out = "{\"traceEvents\":[";
+    Registry &registry = _registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    const uint64_t trace = g_traceNumber.load(std::memory_order_acquire);
+    for (const auto &buffer : registry.buffers) {
+        if (trace == 0 || buffer->trace.load(std::memory_order_acquire) != trace) {
+            continue;
+        }
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent &event = buffer->chunks[i / s_chunkSize].load(std::memory_order_acquire)[i % s_chunkSize];
+            if (event.asyncId == 0) {
+                _append_event(out, event, buffer->tid, "X", event.start);
+            } else {
+                _append_event(out, event, buffer->tid, "b", event.start);
+                _append_event(out, event, buffer->tid, "e", event.start + event.duration);
+            }
+        }
+    }
+    out.append("],\"displayTimeUnit\":\"ms\"}");
+
+    const uint64_t dropped = g_droppedSpans.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        PROXY_LOG_WARNING("%llu proxy trace spans were dropped, a thread recorded too many", static_cast<unsigned long long>(dropped));
+    }
+    return out;
+}
+
+} //proxy
@@ -0,0 +1,91 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "ProxyTracing.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace proxy {
+
+//set while a trace is being recorded, read without ordering on every span
+extern std::atomic<bool> g_proxyTracing;
+
+/**
+ * @brief Whether a trace is being recorded, the only cost of a span while it is not
+ */
+inline bool tracingEnabled()
+{
+    return g_proxyTracing.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Records a span that has already ended. Spans with an asyncId are drawn as their own track instead of on
+ *        the recording thread, for work running side by side such as concurrent transfers; spans sharing it nest.
+ * @param name a string literal, only the pointer is kept
+ * @param detail what the span worked on, e.g. a command or a proxy url, cut to a few dozen characters
+ */
+void recordTraceSpan(const char *name, std::string_view detail, std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end, uint64_t asyncId = 0);
+
+/**
+ * @return A new id for recordTraceSpan
+ */
+uint64_t nextTraceId();
+
+/**
+ * @brief Records the span of the scope it lives in when a trace is being recorded
+ */
+class TraceSpan
+{
+public:
+    /**
+     * @param detail must outlive the span
+     */
+    explicit TraceSpan(const char *name, std::string_view detail = {})
+    {
+        if (tracingEnabled()) {
+            m_name = name;
+            m_detail = detail;
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+    ~TraceSpan()
+    {
+        if (m_name) {
+            recordTraceSpan(m_name, m_detail, m_start, std::chrono::steady_clock::now());
+        }
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator = (const TraceSpan&) = delete;
+
+private:
+    const char *m_name = nullptr;
+    std::string_view m_detail;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Tags the spans recorded on this thread with the guid of a request until it goes out of scope
+ */
+class TraceRequestScope
+{
+public:
+    explicit TraceRequestScope(const std::string &guid);
+    ~TraceRequestScope();
+    TraceRequestScope(const TraceRequestScope&) = delete;
+    TraceRequestScope& operator = (const TraceRequestScope&) = delete;
+
+private:
+    const std::string *m_previous;
+};
+
+} //proxy
@@ -1,8 +1,8 @@
 #pragma once
 #include "IProxyDiscoveryEngine.h"
 #include "ISystemConfigurationAPI.h"
+#include "ObserverRegistry.hpp"
 
-#include <deque>
 #include <memory>
 #include <thread>
 
@@ -21,6 +21,9 @@ public:
     ProxyDiscoveryEngine& operator = (ProxyDiscoveryEngine&&) = delete;
     
     void addObserver(IProxyObserver& pObserver) override;
+    void removeObserver(IProxyObserver& pObserver) override;
+    //the timeout overload keeps its default, requests are not abandoned on macOS
+    using IProxyDiscoveryEngine::requestProxiesAsync;
     void requestProxiesAsync(const std::string& testUrl, const std::string &pacUrl, const std::string& guid) override;
     std::list<ProxyRecord> getProxies(const std::string& testUrl, const std::string &pacUrl) override;
     void waitPrevOpCompleted() override;
@@ -28,7 +31,7 @@ public:
 private:
     std::list<ProxyRecord> getProxiesInternal(const std::string& testUrl, const std::string &pacUrlStr);
     void notifyObservers(const std::list<ProxyRecord>& proxies, const std::string& guid);
-    std::deque<IProxyObserver*> m_observers;
+    ObserverRegistry m_observers;
     std::shared_ptr<std::thread> m_thread;
     std::shared_ptr<std::thread> m_threadSync;
     std::shared_ptr<ISystemConfigurationAPI> m_pConfigurationAPI;
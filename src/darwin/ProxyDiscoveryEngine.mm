@@ -221,7 +221,12 @@ std::list<ProxyRecord> ProxyDiscoveryEngine::getProxiesInternal(const std::strin
 
 void ProxyDiscoveryEngine::addObserver(IProxyObserver& pObserver)
 {
-    m_observers.push_back(&pObserver);
+    m_observers.add(pObserver);
+}
+
+void ProxyDiscoveryEngine::removeObserver(IProxyObserver& pObserver)
+{
+    m_observers.remove(pObserver);
 }
 
 void ProxyDiscoveryEngine::requestProxiesAsync(const std::string& testUrl, const std::string &pacUrlStr, const std::string& guid)
@@ -248,13 +253,8 @@ void ProxyDiscoveryEngine::waitPrevOpCompleted()
 
 void ProxyDiscoveryEngine::notifyObservers(const std::list<ProxyRecord>& proxies, const std::string& guid)
 {
-    for(auto* pObserver: m_observers)
-    {
-        if (pObserver) {
-            //TODO: maybe we need to call observer on the main thread?
-            pObserver->updateProxyList(proxies, guid);
-        }
-    }
+    //TODO: maybe we need to call observer on the main thread?
+    m_observers.notify([&proxies, &guid](IProxyObserver& observer) { observer.updateProxyList(proxies, guid); });
 }
 
 std::list<ProxyRecord> ProxyDiscoveryEngine::getProxies(const std::string& testUrl, const std::string &pacUrl)
@@ -0,0 +1,35 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+
+namespace proxy {
+
+/**
+ * @brief Makes room for one more entry in a cache of at most maxEntries entries. The expired entries are dropped
+ *        and, when it is still full, the entry closest to expiry. The mapped values need an expiresAt time point.
+ */
+template <typename Map>
+void evictForInsert(Map &entries, size_t maxEntries, std::chrono::steady_clock::time_point now)
+{
+    if (entries.size() < maxEntries) {
+        return;
+    }
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        it = (it->second.expiresAt <= now) ? entries.erase(it) : std::next(it);
+    }
+    if (!entries.empty() && entries.size() >= maxEntries) {
+        entries.erase(std::min_element(entries.begin(), entries.end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.second.expiresAt < rhs.second.expiresAt; }));
+    }
+}
+
+} //proxy
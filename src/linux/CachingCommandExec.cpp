@@ -0,0 +1,122 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "CachingCommandExec.hpp"
+#include "CacheEviction.hpp"
+#include "ProxyLoggerDef.hpp"
+#include "ProxyMetricsDef.hpp"
+
+namespace {
+
+//the command and its arguments, each terminated by a NUL so no two argument lists collide
+std::string _cache_key(const std::string &cmd, const std::vector<std::string> &argv)
+{
+    size_t length = cmd.size() + 1;
+    for (const auto &arg : argv) {
+        length += arg.size() + 1;
+    }
+    std::string key;
+    key.reserve(length);
+    key.append(cmd).push_back('\0');
+    for (const auto &arg : argv) {
+        key.append(arg).push_back('\0');
+    }
+    return key;
+}
+
+} //namespace
+
+CachingCommandExec::CachingCommandExec(std::shared_ptr<IProxyCommandExec> commandExecutor,
+    std::chrono::milliseconds ttl, size_t maxEntries) :
+    m_commandExecutor(std::move(commandExecutor)),
+    m_ttl(ttl),
+    m_maxEntries(maxEntries)
+{
+}
+
+CommandOutput CachingCommandExec::ExecuteCommandCaptureOutput(const std::string &cmd, const std::vector<std::string> &argv)
+{
+    const std::string key = _cache_key(cmd, argv);
+    std::promise<CommandOutput> promise;
+    uint64_t generation = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const auto cached = m_entries.find(key);
+        if (cached != m_entries.end()) {
+            if (cached->second.expiresAt > std::chrono::steady_clock::now()) {
+                PROXY_LOG_DEBUG("Using cached output of %s", cmd.c_str());
+                proxy::countCacheLookup("command", true);
+                return cached->second.output;
+            }
+            m_entries.erase(cached);
+        }
+
+        const auto running = m_running.find(key);
+        if (running != m_running.end()) {
+            std::shared_future<CommandOutput> result = running->second;
+            lock.unlock();
+            PROXY_LOG_DEBUG("Waiting for the running %s", cmd.c_str());
+            proxy::countCacheLookup("command", true);
+            return result.get();
+        }
+        m_running.emplace(key, promise.get_future().share());
+        generation = m_generation;
+    }
+    proxy::countCacheLookup("command", false);
+
+    try {
+        CommandOutput output = m_commandExecutor->ExecuteCommandCaptureOutput(cmd, argv);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running.erase(key);
+            if (generation == m_generation) {
+                store(key, output, std::chrono::steady_clock::now());
+            }
+        }
+        promise.set_value(output);
+        return output;
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+std::string CachingCommandExec::getEnvironmentVar(const std::string &name)
+{
+    return m_commandExecutor->getEnvironmentVar(name);
+}
+
+void CachingCommandExec::invalidate()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        ++m_generation;
+    }
+    m_commandExecutor->invalidate();
+}
+
+size_t CachingCommandExec::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void CachingCommandExec::store(const std::string &key, const CommandOutput &output, std::chrono::steady_clock::time_point now)
+{
+    if (m_ttl.count() <= 0 || m_maxEntries == 0) {
+        return;
+    }
+
+    if (m_entries.find(key) == m_entries.end()) {
+        proxy::evictForInsert(m_entries, m_maxEntries, now);
+    }
+    m_entries[key] = CacheEntry{ output, now + m_ttl };
+}
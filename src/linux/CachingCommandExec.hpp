@@ -0,0 +1,67 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IProxyCommandExec.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief An IProxyCommandExec decorator that remembers command output for a limited time.
+ *        Concurrent calls with the same command and arguments share one execution. Commands that throw are not
+ *        remembered. Environment variables are read straight through, they cost no process.
+ */
+class CachingCommandExec : public IProxyCommandExec
+{
+public:
+    /**
+     * @param commandExecutor the executor used on cache misses
+     * @param ttl how long a command's output is reused
+     * @param maxEntries the maximum number of cached outputs
+     */
+    explicit CachingCommandExec(std::shared_ptr<IProxyCommandExec> commandExecutor,
+        std::chrono::milliseconds ttl = std::chrono::seconds(30), size_t maxEntries = 64);
+
+    CommandOutput ExecuteCommandCaptureOutput(const std::string &cmd, const std::vector<std::string> &argv) override;
+
+    std::string getEnvironmentVar(const std::string &name) override;
+
+    /**
+     * @brief Drops all cached outputs, commands already running are not cached when they finish
+     */
+    void invalidate() override;
+
+    /**
+     * @return The number of cached outputs, including expired ones not yet evicted
+     */
+    size_t size() const;
+
+private:
+    struct CacheEntry
+    {
+        CommandOutput output;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    void store(const std::string &key, const CommandOutput &output, std::chrono::steady_clock::time_point now);
+
+    std::shared_ptr<IProxyCommandExec> m_commandExecutor;
+    std::chrono::milliseconds m_ttl;
+    size_t m_maxEntries;
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, CacheEntry> m_entries;
+    std::unordered_map<std::string, std::shared_future<CommandOutput>> m_running;
+    //bumped by invalidate() so results of commands started before it are not stored
+    uint64_t m_generation = 0;
+};
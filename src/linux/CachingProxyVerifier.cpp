@@ -0,0 +1,135 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "CachingProxyVerifier.hpp"
+#include "CacheEviction.hpp"
+#include "ProxyLoggerDef.hpp"
+#include "CancellationToken.hpp"
+#include "ProxyMetricsDef.hpp"
+
+#include <functional>
+
+namespace proxy {
+
+std::size_t CachingProxyVerifier::CacheKeyHasher::operator()(const CacheKey &key) const
+{
+    std::size_t seed = std::hash<std::string>{}(key.testUrl);
+    auto combine = [&seed](std::size_t value) {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    };
+    combine(std::hash<std::string>{}(key.url));
+    combine(key.port);
+    combine(static_cast<std::size_t>(key.proxyType));
+    return seed;
+}
+
+CachingProxyVerifier::CachingProxyVerifier(std::shared_ptr<IProxyVerifier> proxyVerifier,
+    std::chrono::milliseconds positiveTtl, std::chrono::milliseconds negativeTtl, size_t maxEntries) :
+    m_proxyVerifier(std::move(proxyVerifier)),
+    m_positiveTtl(positiveTtl),
+    m_negativeTtl(negativeTtl),
+    m_maxEntries(maxEntries)
+{
+}
+
+bool CachingProxyVerifier::verifyProxy(const std::string &testUrl, const ProxyRecord &proxyRecord)
+{
+    CacheKey key{ testUrl, proxyRecord.url, proxyRecord.port, proxyRecord.proxyType };
+    if (auto cached = lookup(key, std::chrono::steady_clock::now())) {
+        PROXY_LOG_DEBUG("Using cached verification result for proxy %s", proxyRecord.url.c_str());
+        return *cached;
+    }
+
+    const bool verified = m_proxyVerifier->verifyProxy(testUrl, proxyRecord);
+    store(std::move(key), verified, std::chrono::steady_clock::now());
+    return verified;
+}
+
+std::vector<bool> CachingProxyVerifier::verifyProxies(const std::string &testUrl, const std::vector<ProxyRecord> &proxies)
+{
+    std::vector<bool> results(proxies.size(), false);
+    std::vector<ProxyRecord> misses;
+    std::vector<size_t> missIndexes;
+
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        const ProxyRecord &proxy = proxies[i];
+        if (auto cached = lookup({ testUrl, proxy.url, proxy.port, proxy.proxyType }, now)) {
+            PROXY_LOG_DEBUG("Using cached verification result for proxy %s", proxy.url.c_str());
+            results[i] = *cached;
+        } else {
+            misses.push_back(proxy);
+            missIndexes.push_back(i);
+        }
+    }
+
+    if (misses.empty()) {
+        return results;
+    }
+
+    const std::vector<bool> verified = m_proxyVerifier->verifyProxies(testUrl, misses);
+    const auto verifiedAt = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < misses.size() && i < verified.size(); ++i) {
+        results[missIndexes[i]] = verified[i];
+        store({ testUrl, misses[i].url, misses[i].port, misses[i].proxyType }, verified[i], verifiedAt);
+    }
+    return results;
+}
+
+std::optional<ProxyLatency> CachingProxyVerifier::latency(const ProxyRecord &proxyRecord)
+{
+    return m_proxyVerifier->latency(proxyRecord);
+}
+
+void CachingProxyVerifier::invalidate()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+size_t CachingProxyVerifier::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+std::optional<bool> CachingProxyVerifier::lookup(const CacheKey &key, std::chrono::steady_clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        countCacheLookup("verification", false);
+        return std::nullopt;
+    }
+    if (it->second.expiresAt <= now) {
+        m_entries.erase(it);
+        countCacheLookup("verification", false);
+        return std::nullopt;
+    }
+    countCacheLookup("verification", true);
+    return it->second.verified;
+}
+
+void CachingProxyVerifier::store(CacheKey key, bool verified, std::chrono::steady_clock::time_point now)
+{
+    const auto ttl = verified ? m_positiveTtl : m_negativeTtl;
+    if (ttl.count() <= 0 || m_maxEntries == 0) {
+        return;
+    }
+    // a verification cut short by its request says nothing about the proxy
+    const CancellationToken *token = CancellationToken::current();
+    if (token && token->stopRequested()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.find(key) == m_entries.end()) {
+        evictForInsert(m_entries, m_maxEntries, now);
+    }
+    m_entries[std::move(key)] = CacheEntry{ verified, now + ttl };
+}
+
+} //proxy
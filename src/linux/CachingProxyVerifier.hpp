@@ -0,0 +1,100 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IProxyVerifier.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief An IProxyVerifier decorator that remembers verification results for a limited time.
+ *        Successful and failed verifications expire independently, so a dead proxy is retried sooner
+ *        than a working one is re-checked.
+ */
+class CachingProxyVerifier : public IProxyVerifier
+{
+public:
+    /**
+     * @param proxyVerifier the verifier used on cache misses
+     * @param positiveTtl how long a passed verification is reused
+     * @param negativeTtl how long a failed verification is reused
+     * @param maxEntries the maximum number of cached results
+     */
+    explicit CachingProxyVerifier(std::shared_ptr<IProxyVerifier> proxyVerifier,
+        std::chrono::milliseconds positiveTtl = std::chrono::minutes(5),
+        std::chrono::milliseconds negativeTtl = std::chrono::seconds(30),
+        size_t maxEntries = 256);
+
+    bool verifyProxy(const std::string &testUrl, const ProxyRecord &proxyRecord) override;
+
+    /**
+     * @brief Answers from the cache where possible and forwards the remaining proxies to the
+     *        wrapped verifier as a single batch
+     */
+    std::vector<bool> verifyProxies(const std::string &testUrl, const std::vector<ProxyRecord> &proxies) override;
+
+    /**
+     * @brief The latency measured by the wrapped verifier, as of its last verification of the proxy
+     */
+    std::optional<ProxyLatency> latency(const ProxyRecord &proxyRecord) override;
+
+    /**
+     * @brief Drops all cached results
+     */
+    void invalidate() override;
+
+    /**
+     * @return The number of cached results, including expired ones not yet evicted
+     */
+    size_t size() const;
+
+private:
+    struct CacheKey
+    {
+        std::string testUrl;
+        std::string url;
+        uint32_t port;
+        ProxyTypes proxyType;
+
+        bool operator ==(const CacheKey &rhs) const
+        {
+            return (port == rhs.port) && (proxyType == rhs.proxyType) && (url == rhs.url) && (testUrl == rhs.testUrl);
+        }
+    };
+
+    struct CacheKeyHasher
+    {
+        std::size_t operator()(const CacheKey &key) const;
+    };
+
+    struct CacheEntry
+    {
+        bool verified;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    std::optional<bool> lookup(const CacheKey &key, std::chrono::steady_clock::time_point now);
+    void store(CacheKey key, bool verified, std::chrono::steady_clock::time_point now);
+
+    std::shared_ptr<IProxyVerifier> m_proxyVerifier;
+    std::chrono::milliseconds m_positiveTtl;
+    std::chrono::milliseconds m_negativeTtl;
+    size_t m_maxEntries;
+    mutable std::mutex m_mutex;
+    std::unordered_map<CacheKey, CacheEntry, CacheKeyHasher> m_entries;
+};
+
+} //proxy
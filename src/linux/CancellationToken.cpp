@@ -0,0 +1,93 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "CancellationToken.hpp"
+
+#include <algorithm>
+
+namespace proxy {
+
+namespace {
+
+thread_local CancellationToken *current_token = nullptr;
+
+} //namespace
+
+CancellationToken::CancellationToken(std::optional<Clock::time_point> deadline) :
+    m_deadline(deadline)
+{
+}
+
+void CancellationToken::cancel()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_cancelled.exchange(true)) {
+        return;
+    }
+    for (const auto &hook : m_hooks) {
+        hook.second();
+    }
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return m_cancelled;
+}
+
+bool CancellationToken::isExpired() const
+{
+    return m_deadline && Clock::now() >= *m_deadline;
+}
+
+bool CancellationToken::stopRequested() const
+{
+    return isCancelled() || isExpired();
+}
+
+std::optional<CancellationToken::Clock::time_point> CancellationToken::deadline() const
+{
+    return m_deadline;
+}
+
+CancellationToken::Clock::time_point CancellationToken::limitDeadline(Clock::time_point deadline) const
+{
+    return m_deadline ? std::min(deadline, *m_deadline) : deadline;
+}
+
+size_t CancellationToken::addHook(std::function<void()> hook)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_cancelled) {
+        hook();
+    }
+    m_hooks.emplace_back(m_nextHookId, std::move(hook));
+    return m_nextHookId++;
+}
+
+void CancellationToken::removeHook(size_t id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hooks.erase(std::remove_if(m_hooks.begin(), m_hooks.end(),
+        [id](const auto &hook) { return hook.first == id; }), m_hooks.end());
+}
+
+CancellationToken *CancellationToken::current()
+{
+    return current_token;
+}
+
+CancellationToken::Scope::Scope(CancellationToken *token) :
+    m_previous(current_token)
+{
+    current_token = token;
+}
+
+CancellationToken::Scope::~Scope()
+{
+    current_token = m_previous;
+}
+
+} //proxy
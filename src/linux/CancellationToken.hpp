@@ -0,0 +1,100 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief The cancellation state and deadline of one discovery request.
+ *        The engine makes a request's token current on the thread discovering it, so subprocesses and curl
+ *        transfers started for the request can poll it or register a hook that interrupts them.
+ */
+class CancellationToken
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param deadline when the request times out, none for a request without a deadline
+     */
+    explicit CancellationToken(std::optional<Clock::time_point> deadline = std::nullopt);
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator = (const CancellationToken&) = delete;
+
+    /**
+     * @brief Marks the request cancelled and runs the registered hooks
+     */
+    void cancel();
+
+    bool isCancelled() const;
+
+    /**
+     * @return True once the deadline has passed
+     */
+    bool isExpired() const;
+
+    /**
+     * @return True when the request is cancelled or past its deadline
+     */
+    bool stopRequested() const;
+
+    std::optional<Clock::time_point> deadline() const;
+
+    /**
+     * @return The earlier of the request's deadline and the given one
+     */
+    Clock::time_point limitDeadline(Clock::time_point deadline) const;
+
+    /**
+     * @brief Registers a hook run on cancellation, it runs at once when the request is already cancelled.
+     *        Hooks run with the token locked and must not add or remove hooks.
+     * @return An id for removeHook
+     */
+    size_t addHook(std::function<void()> hook);
+
+    /**
+     * @brief Unregisters a hook, once this returns the hook is not running and will not run
+     */
+    void removeHook(size_t id);
+
+    /**
+     * @return The token of the request the calling thread works on, null outside a request
+     */
+    static CancellationToken *current();
+
+    /**
+     * @brief Makes a token current on the calling thread while in scope
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(CancellationToken *token);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator = (const Scope&) = delete;
+
+    private:
+        CancellationToken *m_previous;
+    };
+
+private:
+    std::atomic<bool> m_cancelled{ false };
+    std::optional<Clock::time_point> m_deadline;
+    std::mutex m_mutex;
+    std::vector<std::pair<size_t, std::function<void()>>> m_hooks;
+    size_t m_nextHookId = 0;
+};
+
+} //proxy
@@ -0,0 +1,134 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "CurlHandlePool.hpp"
+#include "ProxyLoggerDef.hpp"
+#include "CancellationToken.hpp"
+
+#include <algorithm>
+
+#include <unistd.h>
+
+namespace proxy {
+
+namespace {
+
+//a non-zero return aborts the transfer with CURLE_ABORTED_BY_CALLBACK
+int _abort_cancelled(void *clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+{
+    return static_cast<const CancellationToken*>(clientp)->isCancelled() ? 1 : 0;
+}
+
+} //namespace
+
+void CurlHandlePool::HandleReleaser::operator()(CURL *curl) const
+{
+    pool->release(curl);
+}
+
+CurlHandlePool::CurlHandlePool(size_t maxIdleHandles) : m_maxIdleHandles(maxIdleHandles)
+{
+    m_share = curl_share_init();
+    if (!m_share) {
+        PROXY_LOG_ERROR("curl_share_init failed, curl handles will not share caches");
+        return;
+    }
+    curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, &CurlHandlePool::lockShare);
+    curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, &CurlHandlePool::unlockShare);
+    curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+}
+
+CurlHandlePool::~CurlHandlePool()
+{
+    // handles must be gone before the share object they are attached to
+    for (CURL *curl : m_idleHandles) {
+        curl_easy_cleanup(curl);
+    }
+    if (m_share) {
+        curl_share_cleanup(m_share);
+    }
+}
+
+CurlHandlePool::Handle CurlHandlePool::acquire()
+{
+    CURL *curl = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idleHandles.empty()) {
+            curl = m_idleHandles.back();
+            m_idleHandles.pop_back();
+        }
+    }
+    if (!curl) {
+        curl = curl_easy_init();
+        if (!curl) {
+            return Handle{ nullptr, HandleReleaser{ this } };
+        }
+    }
+    if (m_share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+    }
+    return Handle{ curl, HandleReleaser{ this } };
+}
+
+void CurlHandlePool::release(CURL *curl)
+{
+    // reset drops the options of the previous transfer but keeps the caches and live connections
+    curl_easy_reset(curl);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_idleHandles.size() < m_maxIdleHandles) {
+            m_idleHandles.push_back(curl);
+            return;
+        }
+    }
+    curl_easy_cleanup(curl);
+}
+
+void CurlHandlePool::lockShare(CURL *, curl_lock_data data, curl_lock_access, void *userptr)
+{
+    static_cast<CurlHandlePool*>(userptr)->m_shareLocks[data].lock();
+}
+
+void CurlHandlePool::unlockShare(CURL *, curl_lock_data data, void *userptr)
+{
+    static_cast<CurlHandlePool*>(userptr)->m_shareLocks[data].unlock();
+}
+
+std::string caBundlePath()
+{
+    // different paths for rhel/debian
+    const std::string paths[] {
+        "/etc/pki/tls/certs/ca-bundle.crt",
+        "/etc/ssl/certs/ca-certificates.crt"
+    };
+    for (const std::string &path : paths) {
+        if (access(path.c_str(), R_OK) == 0) {
+            return path;
+        }
+    }
+    return "";
+}
+
+void limitTransfer(CURL *curl, std::chrono::milliseconds timeout)
+{
+    CancellationToken *token = CancellationToken::current();
+    if (token) {
+        const auto now = CancellationToken::Clock::now();
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(token->limitDeadline(now + timeout) - now);
+        // zero would mean no timeout at all
+        timeout = std::max(remaining, std::chrono::milliseconds(1));
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &_abort_cancelled);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, token);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
+}
+
+} //proxy
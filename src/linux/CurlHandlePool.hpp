@@ -0,0 +1,73 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <curl/curl.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief Recycles curl easy handles and ties them to one share object, so DNS lookups,
+ *        TLS sessions and open connections survive between verifications.
+ */
+class CurlHandlePool
+{
+public:
+    struct HandleReleaser
+    {
+        CurlHandlePool *pool;
+        void operator()(CURL *curl) const;
+    };
+    using Handle = std::unique_ptr<CURL, HandleReleaser>;
+
+    /**
+     * @param maxIdleHandles the number of released handles kept for reuse, extra ones are destroyed
+     */
+    explicit CurlHandlePool(size_t maxIdleHandles = 8);
+    ~CurlHandlePool();
+    CurlHandlePool(const CurlHandlePool&) = delete;
+    CurlHandlePool& operator = (const CurlHandlePool&) = delete;
+
+    /**
+     * @brief Takes an idle handle or creates a new one. The handle has default options
+     *        and is attached to the pool's share object.
+     * @return The handle, returned to the pool when it goes out of scope. Empty if curl failed to
+     *         allocate a handle.
+     */
+    Handle acquire();
+
+private:
+    void release(CURL *curl);
+
+    static void lockShare(CURL *curl, curl_lock_data data, curl_lock_access access, void *userptr);
+    static void unlockShare(CURL *curl, curl_lock_data data, void *userptr);
+
+    CURLSH *m_share = nullptr;
+    std::mutex m_shareLocks[CURL_LOCK_DATA_LAST];
+    std::mutex m_mutex;
+    std::vector<CURL*> m_idleHandles;
+    size_t m_maxIdleHandles;
+};
+
+/**
+ * @return The system CA bundle for CURLOPT_CAINFO, or an empty string to use curl's default
+ */
+std::string caBundlePath();
+
+/**
+ * @brief Sets the transfer timeout, shortened to the deadline of the calling thread's discovery request, and
+ *        makes the transfer abort once that request is cancelled
+ */
+void limitTransfer(CURL *curl, std::chrono::milliseconds timeout);
+
+} //proxy
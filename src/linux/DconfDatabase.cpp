@@ -0,0 +1,349 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "DconfDatabase.hpp"
+#include "ProxyLoggerDef.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+
+namespace proxy {
+
+namespace {
+
+//"GVariant" read as two little-endian words
+const uint32_t kGvdbSignature0 = 0x72615647;
+const uint32_t kGvdbSignature1 = 0x746e6169;
+const size_t kGvdbHeaderSize = 24;
+const size_t kGvdbHashHeaderSize = 8;
+const size_t kGvdbHashItemSize = 24;
+const uint32_t kGvdbNoParent = 0xffffffffu;
+
+uint32_t _read_u32(const char *p)
+{
+    const auto *b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+           (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+uint16_t _read_u16(const char *p)
+{
+    const auto *b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint16_t>(b[0] | (b[1] << 8));
+}
+
+uint32_t _gvdb_hash(std::string_view key)
+{
+    uint32_t hash = 5381;
+    for (char c : key) {
+        hash = hash * 33 + static_cast<uint32_t>(static_cast<signed char>(c));
+    }
+    return hash;
+}
+
+//reads a GVariant framing offset of the given size
+size_t _read_offset(std::string_view data, size_t pos, size_t offsetSize)
+{
+    size_t value = 0;
+    for (size_t i = 0; i < offsetSize; ++i) {
+        value |= static_cast<size_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+    }
+    return value;
+}
+
+size_t _offset_size(size_t containerSize)
+{
+    if (containerSize <= 0xff) {
+        return 1;
+    } else if (containerSize <= 0xffff) {
+        return 2;
+    }
+    return 4;
+}
+
+} //namespace
+
+struct DconfDatabase::HashItem
+{
+    const char *raw;
+
+    uint32_t hashValue() const { return _read_u32(raw); }
+    uint32_t parent() const { return _read_u32(raw + 4); }
+    uint32_t keyStart() const { return _read_u32(raw + 8); }
+    uint16_t keySize() const { return _read_u16(raw + 12); }
+    char type() const { return raw[14]; }
+    uint32_t valueStart() const { return _read_u32(raw + 16); }
+    uint32_t valueEnd() const { return _read_u32(raw + 20); }
+};
+
+DconfDatabase::DconfDatabase(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        PROXY_LOG_DEBUG("Unable to open dconf database %s: %d", path.c_str(), errno);
+        return;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(kGvdbHeaderSize)) {
+        void *mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            m_data = static_cast<const char*>(mapping);
+            m_size = static_cast<size_t>(st.st_size);
+        }
+    }
+    close(fd);
+
+    if (m_data && !parseRootTable()) {
+        PROXY_LOG_WARNING("dconf database %s is not a valid GVDB file", path.c_str());
+        munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+DconfDatabase::~DconfDatabase()
+{
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+bool DconfDatabase::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+bool DconfDatabase::parseRootTable()
+{
+    if (_read_u32(m_data) != kGvdbSignature0 || _read_u32(m_data + 4) != kGvdbSignature1) {
+        //big-endian databases are not produced on the platforms we support
+        return false;
+    }
+    if (_read_u32(m_data + 8) != 0) {
+        return false;
+    }
+
+    const std::string_view root = slice(_read_u32(m_data + 16), _read_u32(m_data + 20));
+    if (root.size() < kGvdbHashHeaderSize) {
+        return false;
+    }
+
+    const uint32_t bloomHeader = _read_u32(root.data());
+    m_bloomShift = bloomHeader >> 27;
+    m_bloomWordCount = bloomHeader & ((1u << 27) - 1);
+    m_bucketCount = _read_u32(root.data() + 4);
+
+    size_t offset = kGvdbHashHeaderSize;
+    if ((root.size() - offset) / 4 < m_bloomWordCount) {
+        return false;
+    }
+    m_bloomWords = root.data() + offset;
+    offset += static_cast<size_t>(m_bloomWordCount) * 4;
+
+    if ((root.size() - offset) / 4 < m_bucketCount) {
+        return false;
+    }
+    m_buckets = root.data() + offset;
+    offset += static_cast<size_t>(m_bucketCount) * 4;
+
+    m_items = root.data() + offset;
+    m_itemCount = static_cast<uint32_t>((root.size() - offset) / kGvdbHashItemSize);
+    return true;
+}
+
+std::string_view DconfDatabase::slice(uint32_t start, uint32_t end) const
+{
+    if (start > end || end > m_size) {
+        return {};
+    }
+    return std::string_view(m_data + start, end - start);
+}
+
+DconfDatabase::HashItem DconfDatabase::itemAt(uint32_t index) const
+{
+    return HashItem{ m_items + static_cast<size_t>(index) * kGvdbHashItemSize };
+}
+
+bool DconfDatabase::checkItemName(HashItem item, std::string_view key) const
+{
+    //item keys are stored relative to their parent, so the key is matched from its end up the parent chain
+    for (uint32_t depth = 0; depth <= m_itemCount; ++depth) {
+        const std::string_view itemKey = slice(item.keyStart(), item.keyStart() + item.keySize());
+        if (itemKey.size() != item.keySize() || itemKey.size() > key.size()) {
+            return false;
+        }
+        if (key.substr(key.size() - itemKey.size()) != itemKey) {
+            return false;
+        }
+        key.remove_suffix(itemKey.size());
+
+        const uint32_t parent = item.parent();
+        if (key.empty() && parent == kGvdbNoParent) {
+            return true;
+        }
+        if (parent >= m_itemCount || itemKey.empty()) {
+            return false;
+        }
+        item = itemAt(parent);
+    }
+    return false;
+}
+
+std::optional<DconfDatabase::HashItem> DconfDatabase::findItem(std::string_view key) const
+{
+    if (!m_data || m_bucketCount == 0 || m_itemCount == 0) {
+        return std::nullopt;
+    }
+
+    const uint32_t hash = _gvdb_hash(key);
+    if (m_bloomWordCount != 0) {
+        uint32_t mask = 1u << (hash & 31);
+        mask |= 1u << ((hash >> m_bloomShift) & 31);
+        const uint32_t word = _read_u32(m_bloomWords + static_cast<size_t>((hash / 32) % m_bloomWordCount) * 4);
+        if ((word & mask) != mask) {
+            return std::nullopt;
+        }
+    }
+
+    const uint32_t bucket = hash % m_bucketCount;
+    uint32_t itemIndex = _read_u32(m_buckets + static_cast<size_t>(bucket) * 4);
+    uint32_t lastIndex = m_itemCount;
+    if (bucket != m_bucketCount - 1) {
+        lastIndex = std::min(_read_u32(m_buckets + static_cast<size_t>(bucket + 1) * 4), m_itemCount);
+    }
+
+    for (; itemIndex < lastIndex; ++itemIndex) {
+        const HashItem item = itemAt(itemIndex);
+        if (item.hashValue() == hash && checkItemName(item, key)) {
+            return item;
+        }
+    }
+    return std::nullopt;
+}
+
+//values are serialized variants: the child value, a nul byte and the child type string
+std::optional<std::string_view> DconfDatabase::readValue(std::string_view key, std::string_view type) const
+{
+    const auto item = findItem(key);
+    if (!item || item->type() != 'v') {
+        return std::nullopt;
+    }
+    const std::string_view variant = slice(item->valueStart(), item->valueEnd());
+    const size_t separator = variant.rfind('\0');
+    if (separator == std::string_view::npos || variant.substr(separator + 1) != type) {
+        return std::nullopt;
+    }
+    return variant.substr(0, separator);
+}
+
+std::optional<std::string_view> DconfDatabase::readString(std::string_view key) const
+{
+    const auto value = readValue(key, "s");
+    if (!value || value->empty() || value->back() != '\0') {
+        return std::nullopt;
+    }
+    const std::string_view str = value->substr(0, value->size() - 1);
+    if (str.find('\0') != std::string_view::npos) {
+        return std::nullopt;
+    }
+    return str;
+}
+
+std::optional<int32_t> DconfDatabase::readInt32(std::string_view key) const
+{
+    const auto value = readValue(key, "i");
+    if (!value || value->size() != 4) {
+        return std::nullopt;
+    }
+    return static_cast<int32_t>(_read_u32(value->data()));
+}
+
+std::optional<std::vector<std::string_view>> DconfDatabase::readStringArray(std::string_view key) const
+{
+    const auto value = readValue(key, "as");
+    if (!value) {
+        return std::nullopt;
+    }
+
+    std::vector<std::string_view> result;
+    const std::string_view data = *value;
+    if (data.empty()) {
+        return result;
+    }
+
+    //variable-size elements are followed by a table with the end offset of each element
+    const size_t offsetSize = _offset_size(data.size());
+    if (data.size() < offsetSize) {
+        return std::nullopt;
+    }
+    const size_t tableStart = _read_offset(data, data.size() - offsetSize, offsetSize);
+    if (tableStart > data.size() || (data.size() - tableStart) % offsetSize != 0) {
+        return std::nullopt;
+    }
+
+    size_t elementStart = 0;
+    for (size_t pos = tableStart; pos < data.size(); pos += offsetSize) {
+        const size_t elementEnd = _read_offset(data, pos, offsetSize);
+        if (elementEnd < elementStart || elementEnd > tableStart || elementEnd == elementStart ||
+            data[elementEnd - 1] != '\0') {
+            return std::nullopt;
+        }
+        result.push_back(data.substr(elementStart, elementEnd - elementStart - 1));
+        elementStart = elementEnd;
+    }
+    return result;
+}
+
+std::optional<GnomeProxySettings> readDconfProxySettings(const std::string &path)
+{
+    const DconfDatabase database{ path };
+    if (!database.isOpen()) {
+        return std::nullopt;
+    }
+
+    const auto mode = database.readString("/system/proxy/mode");
+    if (!mode) {
+        PROXY_LOG_DEBUG("dconf database %s does not set the proxy mode", path.c_str());
+        return std::nullopt;
+    }
+
+    GnomeProxySettings settings;
+    settings.mode = std::string(*mode);
+    if (const auto autoconfigUrl = database.readString("/system/proxy/autoconfig-url")) {
+        settings.autoconfigUrl = std::string(*autoconfigUrl);
+    }
+    if (const auto ignoreHosts = database.readStringArray("/system/proxy/ignore-hosts")) {
+        settings.ignoreHosts.assign(ignoreHosts->begin(), ignoreHosts->end());
+    }
+
+    //keys missing from the database keep the defaults of the org.gnome.system.proxy schemas, as gsettings reports
+    const std::tuple<const char*, GnomeProxyServer*, uint32_t> servers[] = {
+        { "/system/proxy/http/", &settings.http, 8080 },
+        { "/system/proxy/https/", &settings.https, 0 },
+        { "/system/proxy/ftp/", &settings.ftp, 0 },
+        { "/system/proxy/socks/", &settings.socks, 0 },
+    };
+    for (const auto &[prefixKey, server, defaultPort] : servers) {
+        const std::string prefix{ prefixKey };
+        if (const auto host = database.readString(prefix + "host")) {
+            server->host = std::string(*host);
+        }
+        if (const auto port = database.readInt32(prefix + "port")) {
+            server->port = (*port > 0 && *port <= 65535) ? static_cast<uint32_t>(*port) : 0;
+        } else {
+            server->port = defaultPort;
+        }
+    }
+    return settings;
+}
+
+} //proxy
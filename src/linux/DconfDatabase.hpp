@@ -0,0 +1,78 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "GnomeProxySettings.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief Read-only view of a dconf database file (GVDB hash table format).
+ *        The file is memory-mapped and values are decoded in place.
+ */
+class DconfDatabase
+{
+public:
+    /**
+     * @param path the database file, e.g. ~/.config/dconf/user
+     */
+    explicit DconfDatabase(const std::string &path);
+    ~DconfDatabase();
+    DconfDatabase(const DconfDatabase&) = delete;
+    DconfDatabase& operator = (const DconfDatabase&) = delete;
+
+    /**
+     * @return True if the file was mapped and has a valid GVDB header
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Typed lookups of a dconf key such as "/system/proxy/mode"
+     * @return The value, or nullopt if the key is missing or holds a different type.
+     *         Returned views point into the mapping and live as long as this object.
+     */
+    std::optional<std::string_view> readString(std::string_view key) const;
+    std::optional<int32_t> readInt32(std::string_view key) const;
+    std::optional<std::vector<std::string_view>> readStringArray(std::string_view key) const;
+
+private:
+    struct HashItem;
+
+    bool parseRootTable();
+    std::optional<HashItem> findItem(std::string_view key) const;
+    HashItem itemAt(uint32_t index) const;
+    bool checkItemName(HashItem item, std::string_view key) const;
+    std::optional<std::string_view> readValue(std::string_view key, std::string_view type) const;
+    std::string_view slice(uint32_t start, uint32_t end) const;
+
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+    uint32_t m_bloomShift = 0;
+    uint32_t m_bloomWordCount = 0;
+    uint32_t m_bucketCount = 0;
+    uint32_t m_itemCount = 0;
+    const char *m_bloomWords = nullptr;
+    const char *m_buckets = nullptr;
+    const char *m_items = nullptr;
+};
+
+/**
+ * @brief Reads the org.gnome.system.proxy keys (stored under /system/proxy/) from a dconf database
+ * @param path the database file
+ * @return The settings, or nullopt when the file is missing, invalid, or does not set the proxy mode,
+ *         in which case the schema defaults or system databases apply and gsettings must be asked instead
+ */
+std::optional<GnomeProxySettings> readDconfProxySettings(const std::string &path);
+
+} //proxy
@@ -0,0 +1,207 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "DnsCache.hpp"
+#include "CancellationToken.hpp"
+#include "ProxyLoggerDef.hpp"
+#include "ProxyMetricsDef.hpp"
+#include "ProxyTracer.hpp"
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+namespace proxy {
+
+//how often a wait for lookups looks at the cancellation of its request
+static constexpr std::chrono::milliseconds s_cancelPollInterval{ 50 };
+//lookups running at the same time, more hosts wait for a thread
+static constexpr size_t s_maxLookupThreads = 8;
+
+DnsCache::DnsCache(std::chrono::milliseconds ttl, std::chrono::milliseconds negativeTtl, Resolver resolver) :
+    m_ttl(ttl),
+    m_negativeTtl(negativeTtl),
+    m_resolver(std::move(resolver))
+{
+}
+
+DnsCache::~DnsCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    m_lookupQueued.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+std::vector<std::optional<std::vector<std::string>>> DnsCache::resolve(const std::vector<std::string> &hosts,
+                                                                       Clock::time_point deadline)
+{
+    TraceSpan span("resolve proxy hosts");
+    const CancellationToken *token = CancellationToken::current();
+    if (token) {
+        deadline = token->limitDeadline(deadline);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const auto now = Clock::now();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+        it = (it->second.expires <= now) ? m_entries.erase(it) : std::next(it);
+    }
+    for (const auto &host : hosts) {
+        const bool cached = m_entries.count(host) != 0;
+        countCacheLookup("dns", cached);
+        if (!cached && m_resolving.count(host) == 0) {
+            startLookup(host);
+        }
+    }
+
+    const auto pending = [this, &hosts]() {
+        return std::any_of(hosts.begin(), hosts.end(),
+            [this](const std::string &host) { return m_resolving.count(host) != 0; });
+    };
+    while (pending()) {
+        const auto waitStart = Clock::now();
+        if (waitStart >= deadline || (token && token->stopRequested())) {
+            PROXY_LOG_WARNING("Proxy host lookups did not end in time, curl resolves the remaining hosts itself");
+            break;
+        }
+        m_lookupEnded.wait_until(lock, std::min(deadline, waitStart + s_cancelPollInterval));
+    }
+
+    std::vector<std::optional<std::vector<std::string>>> results;
+    results.reserve(hosts.size());
+    for (const auto &host : hosts) {
+        const auto it = m_entries.find(host);
+        if (it != m_entries.end()) {
+            results.emplace_back(it->second.addresses);
+        } else {
+            results.emplace_back(std::nullopt);
+        }
+    }
+    return results;
+}
+
+void DnsCache::startLookup(const std::string &host)
+{
+    m_resolving.insert(host);
+    m_queue.push_back(host);
+    if (m_queue.size() > m_idleThreads && m_threads.size() < s_maxLookupThreads) {
+        try {
+            m_threads.emplace_back(&DnsCache::lookupLoop, this);
+            ++m_idleThreads;
+        } catch (const std::system_error &e) {
+            PROXY_LOG_ERROR("Could not start looking up proxy host %s: %s", host.c_str(), e.what());
+            if (m_threads.empty()) {
+                m_queue.pop_back();
+                m_resolving.erase(host);
+                return;
+            }
+        }
+    }
+    m_lookupQueued.notify_one();
+}
+
+void DnsCache::lookupLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_lookupQueued.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+        if (m_stopping) {
+            return;
+        }
+        const std::string host = std::move(m_queue.front());
+        m_queue.pop_front();
+        --m_idleThreads;
+        lock.unlock();
+
+        std::optional<std::vector<std::string>> addresses;
+        try {
+            addresses = m_resolver(host);
+        } catch (const std::exception &e) {
+            PROXY_LOG_ERROR("Looking up proxy host %s failed: %s", host.c_str(), e.what());
+        }
+        if (!addresses) {
+            //not remembered, curl looks the host up itself and the next discovery tries again
+            PROXY_LOG_INFO("Proxy host %s could not be looked up", host.c_str());
+        } else if (addresses->empty()) {
+            PROXY_LOG_INFO("Proxy host %s does not resolve", host.c_str());
+        }
+
+        lock.lock();
+        if (addresses) {
+            const auto expires = Clock::now() + (addresses->empty() ? m_negativeTtl : m_ttl);
+            m_entries[host] = Entry{ std::move(*addresses), expires };
+        }
+        m_resolving.erase(host);
+        ++m_idleThreads;
+        m_lookupEnded.notify_all();
+    }
+}
+
+void DnsCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+size_t DnsCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+std::optional<std::vector<std::string>> DnsCache::resolveHost(const std::string &host)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *found = nullptr;
+    const int res = getaddrinfo(host.c_str(), nullptr, &hints, &found);
+    if (res != 0) {
+        PROXY_LOG_DEBUG("getaddrinfo for %s failed: %s", host.c_str(), gai_strerror(res));
+        //only an answer about the name itself is worth remembering, not a failure to get one
+#ifdef EAI_NODATA
+        if (res == EAI_NODATA) {
+            return std::vector<std::string>{};
+        }
+#endif
+        if (res == EAI_NONAME) {
+            return std::vector<std::string>{};
+        }
+        return std::nullopt;
+    }
+
+    std::vector<std::string> addresses;
+    for (const addrinfo *info = found; info != nullptr; info = info->ai_next) {
+        char text[INET6_ADDRSTRLEN] = {};
+        std::string address;
+        if (info->ai_family == AF_INET) {
+            inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in*>(info->ai_addr)->sin_addr, text, sizeof(text));
+            address = text;
+        } else if (info->ai_family == AF_INET6) {
+            inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6*>(info->ai_addr)->sin6_addr, text, sizeof(text));
+            address = std::string("[") + text + "]";
+        } else {
+            continue;
+        }
+        if (std::find(addresses.begin(), addresses.end(), address) == addresses.end()) {
+            addresses.push_back(std::move(address));
+        }
+    }
+    freeaddrinfo(found);
+    return addresses;
+}
+
+} //proxy
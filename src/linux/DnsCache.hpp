@@ -0,0 +1,107 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief Resolves proxy host names ahead of their verification and remembers the addresses, so every transfer
+ *        to a host reuses one lookup. Names that do not resolve are remembered for a shorter time.
+ */
+class DnsCache
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Looks up the addresses of a host name, empty when the name does not resolve and nullopt when the
+     *        lookup failed for another reason, e.g. the name server could not be reached
+     */
+    using Resolver = std::function<std::optional<std::vector<std::string>>(const std::string &host)>;
+
+    /**
+     * @param ttl how long the addresses of a host are reused
+     * @param negativeTtl how long a host that did not resolve is reported as unresolvable without a new lookup
+     * @param resolver looks up one host, called on the lookup threads
+     */
+    DnsCache(std::chrono::milliseconds ttl, std::chrono::milliseconds negativeTtl, Resolver resolver = resolveHost);
+    /**
+     * @brief Waits for the running lookups, the queued ones are dropped
+     */
+    ~DnsCache();
+    DnsCache(const DnsCache&) = delete;
+    DnsCache& operator = (const DnsCache&) = delete;
+
+    /**
+     * @brief Resolves the hosts not remembered yet, all at the same time and each name once, and waits for them
+     *        until the deadline, the deadline of the calling thread's discovery request or its cancellation.
+     *        A lookup still running then carries on and is remembered when it ends.
+     * @param hosts the host names, may repeat
+     * @param deadline when to stop waiting for lookups
+     * @return For each host: its addresses, empty when it does not resolve, or nullopt when its lookup failed
+     *         or did not end in time
+     */
+    std::vector<std::optional<std::vector<std::string>>> resolve(const std::vector<std::string> &hosts,
+                                                                 Clock::time_point deadline);
+
+    /**
+     * @brief Forgets every remembered host
+     */
+    void clear();
+
+    /**
+     * @return The number of remembered hosts, expired ones included until the next resolve
+     */
+    size_t size() const;
+
+    /**
+     * @brief Looks up a host with getaddrinfo
+     * @return Its IPv4 addresses and bracketed IPv6 addresses, e.g. "192.0.2.1" and "[2001:db8::1]", empty when
+     *         the name does not exist or has no address, nullopt when the lookup failed for another reason
+     */
+    static std::optional<std::vector<std::string>> resolveHost(const std::string &host);
+
+private:
+    struct Entry
+    {
+        std::vector<std::string> addresses;
+        Clock::time_point expires;
+    };
+
+    //called with m_mutex held
+    void startLookup(const std::string &host);
+    void lookupLoop();
+
+    std::chrono::milliseconds m_ttl;
+    std::chrono::milliseconds m_negativeTtl;
+    Resolver m_resolver;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_lookupEnded;
+    std::condition_variable m_lookupQueued;
+    std::unordered_map<std::string, Entry> m_entries;
+    //queued or running lookups
+    std::unordered_set<std::string> m_resolving;
+    std::deque<std::string> m_queue;
+    size_t m_idleThreads = 0;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+} //proxy
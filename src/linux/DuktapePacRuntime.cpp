@@ -0,0 +1,191 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "DuktapePacRuntime.hpp"
+#include "CancellationToken.hpp"
+#include "PacUtils.hpp"
+#include "ProxyLoggerDef.hpp"
+
+#include <duktape.h>
+
+namespace proxy {
+
+namespace {
+
+duk_ret_t _dns_resolve(duk_context *ctx)
+{
+    const std::string address = pacDnsResolve(duk_safe_to_string(ctx, 0));
+    if (address.empty()) {
+        duk_push_null(ctx);
+    } else {
+        duk_push_lstring(ctx, address.data(), address.size());
+    }
+    return 1;
+}
+
+duk_ret_t _my_ip_address(duk_context *ctx)
+{
+    const std::string address = pacMyIpAddress();
+    duk_push_lstring(ctx, address.data(), address.size());
+    return 1;
+}
+
+//the limit of the running evaluation, Duktape hands it to the timeout check as the heap udata
+struct ExecutionLimit
+{
+    CancellationToken::Clock::time_point deadline = CancellationToken::Clock::time_point::max();
+    CancellationToken *token = nullptr;
+
+    bool reached() const
+    {
+        return CancellationToken::Clock::now() >= deadline || (token != nullptr && token->stopRequested());
+    }
+};
+
+class DuktapePacScript : public IPacScript
+{
+public:
+    explicit DuktapePacScript(std::chrono::milliseconds evaluationTimeout)
+        : m_evaluationTimeout(evaluationTimeout)
+        , m_ctx(duk_create_heap(nullptr, nullptr, nullptr, &m_limit, nullptr))
+    {
+    }
+    ~DuktapePacScript() override
+    {
+        if (m_ctx != nullptr) {
+            duk_destroy_heap(m_ctx);
+        }
+    }
+    DuktapePacScript(const DuktapePacScript&) = delete;
+    DuktapePacScript& operator = (const DuktapePacScript&) = delete;
+
+    //defines the PAC helper functions and evaluates the script, which has to define FindProxyForURL
+    bool load(const std::string &script)
+    {
+        if (m_ctx == nullptr) {
+            PROXY_LOG_ERROR("Could not create a Duktape heap");
+            return false;
+        }
+
+        duk_push_c_function(m_ctx, _dns_resolve, 1);
+        duk_put_global_string(m_ctx, "dnsResolve");
+        duk_push_c_function(m_ctx, _my_ip_address, 0);
+        duk_put_global_string(m_ctx, "myIpAddress");
+
+        if (!eval(pacUtilsScript(), "PAC helper functions") || !eval(script, "PAC script")) {
+            return false;
+        }
+
+        duk_get_global_string(m_ctx, "FindProxyForURL");
+        const bool hasFunction = duk_is_function(m_ctx, -1);
+        duk_pop(m_ctx);
+        if (!hasFunction) {
+            PROXY_LOG_ERROR("PAC script does not define FindProxyForURL");
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<std::string> findProxyForUrl(const std::string &url, const std::string &host) override
+    {
+        if (!arm()) {
+            return std::nullopt;
+        }
+        duk_get_global_string(m_ctx, "FindProxyForURL");
+        duk_push_lstring(m_ctx, url.data(), url.size());
+        duk_push_lstring(m_ctx, host.data(), host.size());
+        const bool succeeded = duk_pcall(m_ctx, 2) == DUK_EXEC_SUCCESS;
+        const bool interrupted = disarm();
+        if (!succeeded) {
+            if (interrupted) {
+                PROXY_LOG_WARNING("FindProxyForURL was interrupted: %s", duk_safe_to_string(m_ctx, -1));
+            } else {
+                PROXY_LOG_ERROR("FindProxyForURL threw: %s", duk_safe_to_string(m_ctx, -1));
+            }
+            duk_pop(m_ctx);
+            return std::nullopt;
+        }
+        std::optional<std::string> result;
+        if (duk_is_string(m_ctx, -1)) {
+            duk_size_t length = 0;
+            const char *value = duk_get_lstring(m_ctx, -1, &length);
+            result.emplace(value, length);
+        }
+        duk_pop(m_ctx);
+        return result;
+    }
+
+private:
+    //starts the limit of an evaluation, false when the current request is already stopped
+    bool arm()
+    {
+        m_limit.deadline = CancellationToken::Clock::now() + m_evaluationTimeout;
+        m_limit.token = CancellationToken::current();
+        if (m_limit.token != nullptr && m_limit.token->stopRequested()) {
+            PROXY_LOG_DEBUG("Not evaluating the PAC script of a stopped request");
+            m_limit.token = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    //ends the limit of an evaluation, true when it was reached
+    bool disarm()
+    {
+        const bool reached = m_limit.reached();
+        m_limit = ExecutionLimit{};
+        return reached;
+    }
+
+    //evaluates source in the global scope and drops its value, logging the error if there is one
+    bool eval(std::string_view source, const char *what)
+    {
+        if (!arm()) {
+            return false;
+        }
+        const bool succeeded = duk_peval_lstring(m_ctx, source.data(), source.size()) == 0;
+        disarm();
+        if (!succeeded) {
+            PROXY_LOG_ERROR("Could not evaluate %s: %s", what, duk_safe_to_string(m_ctx, -1));
+        }
+        duk_pop(m_ctx);
+        return succeeded;
+    }
+
+    std::chrono::milliseconds m_evaluationTimeout;
+    ExecutionLimit m_limit;
+    duk_context *m_ctx;
+};
+
+} //namespace
+
+DuktapePacRuntime::DuktapePacRuntime(std::chrono::milliseconds evaluationTimeout)
+    : m_evaluationTimeout(evaluationTimeout)
+{
+#ifndef DUK_USE_EXEC_TIMEOUT_CHECK
+    PROXY_LOG_WARNING("Duktape is built without DUK_USE_EXEC_TIMEOUT_CHECK, PAC scripts run without a time limit");
+#endif
+}
+
+std::unique_ptr<IPacScript> DuktapePacRuntime::compile(const std::string &script)
+{
+    auto compiled = std::make_unique<DuktapePacScript>(m_evaluationTimeout);
+    if (!compiled->load(script)) {
+        return nullptr;
+    }
+    return compiled;
+}
+
+} //proxy
+
+#ifdef DUK_USE_EXEC_TIMEOUT_CHECK
+//called by the interpreter while a script runs, see DUK_USE_EXEC_TIMEOUT_CHECK in duk_config.h
+extern "C" duk_bool_t proxy_duktape_exec_timeout_check(void *udata)
+{
+    const auto *limit = static_cast<const proxy::ExecutionLimit*>(udata);
+    return (limit != nullptr && limit->reached()) ? 1 : 0;
+}
+#endif
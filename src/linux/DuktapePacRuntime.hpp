@@ -0,0 +1,36 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IPacScriptRuntime.hpp"
+
+#include <chrono>
+
+namespace proxy {
+
+/**
+ * @brief Compiles PAC scripts with the Duktape interpreter. Every compiled script owns a Duktape heap
+ *        holding the PAC helper functions and the evaluated script.
+ * @note Only built when Duktape is found, see DUKTAPE_INCLUDE_DIR and DUKTAPE_LIBRARY_DIR. Scripts are
+ *       interrupted on timeout or cancellation of the current request only when Duktape is built with
+ *       DUK_USE_EXEC_TIMEOUT_CHECK(udata) calling proxy_duktape_exec_timeout_check(udata).
+ */
+class DuktapePacRuntime : public IPacScriptRuntime
+{
+public:
+    /**
+     * @param evaluationTimeout how long one evaluation of a script may run, an interrupted evaluation fails
+     */
+    explicit DuktapePacRuntime(std::chrono::milliseconds evaluationTimeout = std::chrono::seconds(5));
+
+    std::unique_ptr<IPacScript> compile(const std::string &script) override;
+
+private:
+    std::chrono::milliseconds m_evaluationTimeout;
+};
+
+} //proxy
@@ -0,0 +1,167 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "GnomeProxySettings.hpp"
+#include "ProxyLoggerDef.hpp"
+
+namespace proxy {
+
+namespace {
+
+const std::string_view kGnomeSystemProxySchema{ "org.gnome.system.proxy" };
+
+std::string_view _trim(std::string_view str)
+{
+    const size_t start = str.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    const size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(start, end - start + 1);
+}
+
+//GVariant text strings are quoted with ' or " and use backslash escapes
+std::string _parse_string_literal(std::string_view value, size_t &pos)
+{
+    std::string result;
+    if (pos >= value.size() || (value[pos] != '\'' && value[pos] != '"')) {
+        return result;
+    }
+    const char quote = value[pos++];
+    while (pos < value.size() && value[pos] != quote) {
+        char c = value[pos++];
+        if (c == '\\' && pos < value.size()) {
+            c = value[pos++];
+            if (c == 'n') {
+                c = '\n';
+            } else if (c == 't') {
+                c = '\t';
+            }
+        }
+        result.push_back(c);
+    }
+    if (pos < value.size()) {
+        ++pos; //closing quote
+    }
+    return result;
+}
+
+std::string _parse_string(std::string_view value)
+{
+    size_t pos = 0;
+    return _parse_string_literal(value, pos);
+}
+
+//arrays are printed as ['a', 'b'], an empty array as @as []
+std::vector<std::string> _parse_string_array(std::string_view value)
+{
+    std::vector<std::string> result;
+    size_t pos = value.find('[');
+    if (pos == std::string_view::npos) {
+        return result;
+    }
+    ++pos;
+    while (pos < value.size()) {
+        pos = value.find_first_not_of(", ", pos);
+        if (pos == std::string_view::npos || value[pos] == ']') {
+            break;
+        }
+        const size_t start = pos;
+        std::string element = _parse_string_literal(value, pos);
+        if (pos == start) {
+            break; //not a string literal
+        }
+        result.push_back(std::move(element));
+    }
+    return result;
+}
+
+uint32_t _parse_port(std::string_view value)
+{
+    //integers may carry a type annotation, e.g. "uint32 8080"
+    const size_t space = value.find_last_of(' ');
+    if (space != std::string_view::npos) {
+        value = value.substr(space + 1);
+    }
+    uint32_t port = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') {
+            PROXY_LOG_WARNING("Port could not be parsed");
+            return 0;
+        }
+        port = port * 10 + static_cast<uint32_t>(c - '0');
+        if (port > 65535) {
+            PROXY_LOG_WARNING("Port is out of range");
+            return 0;
+        }
+    }
+    return port;
+}
+
+GnomeProxyServer* _server_for_schema(GnomeProxySettings &settings, std::string_view childSchema)
+{
+    if (childSchema == "http") {
+        return &settings.http;
+    } else if (childSchema == "https") {
+        return &settings.https;
+    } else if (childSchema == "ftp") {
+        return &settings.ftp;
+    } else if (childSchema == "socks") {
+        return &settings.socks;
+    }
+    return nullptr;
+}
+
+} //namespace
+
+GnomeProxySettings parseGsettingsListing(std::string_view output)
+{
+    GnomeProxySettings settings;
+    while (!output.empty()) {
+        const size_t eol = output.find('\n');
+        const std::string_view line = _trim(output.substr(0, eol));
+        output = (eol == std::string_view::npos) ? std::string_view{} : output.substr(eol + 1);
+
+        const size_t schemaEnd = line.find(' ');
+        if (schemaEnd == std::string_view::npos) {
+            continue;
+        }
+        const size_t keyEnd = line.find(' ', schemaEnd + 1);
+        if (keyEnd == std::string_view::npos) {
+            continue;
+        }
+        const std::string_view schema = line.substr(0, schemaEnd);
+        const std::string_view key = line.substr(schemaEnd + 1, keyEnd - schemaEnd - 1);
+        const std::string_view value = _trim(line.substr(keyEnd + 1));
+
+        if (schema.substr(0, kGnomeSystemProxySchema.size()) != kGnomeSystemProxySchema) {
+            continue;
+        }
+        const std::string_view childSchema = schema.substr(kGnomeSystemProxySchema.size());
+        if (childSchema.empty()) {
+            if (key == "mode") {
+                settings.mode = _parse_string(value);
+            } else if (key == "autoconfig-url") {
+                settings.autoconfigUrl = _parse_string(value);
+            } else if (key == "ignore-hosts") {
+                settings.ignoreHosts = _parse_string_array(value);
+            }
+        } else if (childSchema[0] == '.') {
+            GnomeProxyServer *server = _server_for_schema(settings, childSchema.substr(1));
+            if (!server) {
+                continue;
+            }
+            if (key == "host") {
+                server->host = _parse_string(value);
+            } else if (key == "port") {
+                server->port = _parse_port(value);
+            }
+        }
+    }
+    return settings;
+}
+
+} //proxy
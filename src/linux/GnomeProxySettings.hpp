@@ -0,0 +1,43 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace proxy {
+
+struct GnomeProxyServer
+{
+    std::string host;
+    uint32_t port = 0;
+};
+
+/**
+ * @brief The proxy related keys of the org.gnome.system.proxy schema and its child schemas
+ */
+struct GnomeProxySettings
+{
+    std::string mode;
+    std::string autoconfigUrl;
+    std::vector<std::string> ignoreHosts;
+    GnomeProxyServer http;
+    GnomeProxyServer https;
+    GnomeProxyServer ftp;
+    GnomeProxyServer socks;
+};
+
+/**
+ * @brief Parses the output of "gsettings list-recursively org.gnome.system.proxy" in a single pass
+ * @param output lines of "<schema> <key> <value>" with values in GVariant text format
+ * @return The parsed settings, keys missing from the output keep their defaults
+ */
+GnomeProxySettings parseGsettingsListing(std::string_view output);
+
+} //proxy
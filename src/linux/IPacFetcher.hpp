@@ -0,0 +1,26 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace proxy {
+
+class IPacFetcher
+{
+public:
+    virtual ~IPacFetcher() = default;
+    /**
+     * @brief Returns the PAC script served at a http or https url
+     * @param url the script url
+     * @return The script, or nullopt if it could not be downloaded and no copy is cached
+     */
+    virtual std::optional<std::string> fetchScript(const std::string &url) = 0;
+};
+
+} //proxy
@@ -0,0 +1,47 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace proxy {
+
+/**
+ * @brief A PAC script compiled by an IPacScriptRuntime. It keeps its interpreter context alive,
+ *        so calling FindProxyForURL does not parse the script again.
+ */
+class IPacScript
+{
+public:
+    virtual ~IPacScript() = default;
+    /**
+     * @brief Calls FindProxyForURL(url, host) of the script
+     * @param url the url to find a proxy for
+     * @param host the host part of url
+     * @return The returned proxy list, e.g. "PROXY proxy.corp:8080; DIRECT", or nullopt if the call failed
+     */
+    virtual std::optional<std::string> findProxyForUrl(const std::string &url, const std::string &host) = 0;
+};
+
+/**
+ * @brief An embeddable JavaScript interpreter that compiles PAC scripts
+ */
+class IPacScriptRuntime
+{
+public:
+    virtual ~IPacScriptRuntime() = default;
+    /**
+     * @brief Compiles a PAC script together with the standard PAC helper functions
+     * @param script the PAC script source
+     * @return The compiled script, or nullptr if the script could not be compiled
+     */
+    virtual std::unique_ptr<IPacScript> compile(const std::string &script) = 0;
+};
+
+} //proxy
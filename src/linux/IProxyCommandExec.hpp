@@ -13,6 +13,8 @@ struct CommandOutput
 {
     int exitCode_;
     std::string output_;
+    //only filled when the executor captures standard error
+    std::string error_;
 };
 
 class  IProxyCommandExec
@@ -28,4 +30,9 @@ public:
     virtual CommandOutput ExecuteCommandCaptureOutput(const std::string &cmd, const std::vector<std::string> &argv) = 0;
 
     virtual std::string getEnvironmentVar(const std::string &name) = 0;
+
+    /**
+     * @brief Forgets any command output the executor remembers, called when the proxy settings are known to have changed
+     */
+    virtual void invalidate() {}
 };
\ No newline at end of file
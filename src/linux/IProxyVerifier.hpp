@@ -8,7 +8,9 @@
 
 #include "ProxyRecord.h"
 
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace proxy {
 
@@ -23,6 +25,39 @@ public:
      * @return True if proxy server is valid, otherwise false
      */
     virtual bool verifyProxy(const std::string &testUrl, const ProxyRecord &proxyRecord) = 0;
+
+    /**
+     * @brief Verifies a batch of proxy servers against the same test url
+     * @param testUrl the url to perform a test connection to
+     * @param proxies the proxy servers to test
+     * @return Verification results, one per proxy and in the same order as proxies
+     * @note The default implementation verifies the proxies one at a time
+     */
+    virtual std::vector<bool> verifyProxies(const std::string &testUrl, const std::vector<ProxyRecord> &proxies)
+    {
+        std::vector<bool> results;
+        results.reserve(proxies.size());
+        for (const auto &proxy : proxies) {
+            results.push_back(verifyProxy(testUrl, proxy));
+        }
+        return results;
+    }
+
+    /**
+     * @return The smoothed latency measured when verifying the proxy, none when it was not measured.
+     *         The default measures nothing.
+     */
+    virtual std::optional<ProxyLatency> latency(const ProxyRecord &proxyRecord)
+    {
+        (void)proxyRecord;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Forgets any verification results the verifier remembers, called when the proxy settings are known
+     *        to have changed
+     */
+    virtual void invalidate() {}
 };
 
 } //proxy
\ No newline at end of file
@@ -0,0 +1,154 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "KdeProxySettings.hpp"
+#include "ProxyLoggerDef.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace proxy {
+
+namespace {
+
+const std::string_view kProxySettingsGroup{ "Proxy Settings" };
+//kioslaverc is a few hundred bytes, anything this large is not a config file
+const off_t kMaxKioslavercSize = 1024 * 1024;
+
+std::string_view _trim(std::string_view str)
+{
+    const size_t start = str.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    const size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(start, end - start + 1);
+}
+
+//KConfig escapes leading/trailing whitespace and control characters with backslashes
+std::string _unescape(std::string_view value)
+{
+    std::string result;
+    result.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        if (c == '\\' && i + 1 < value.size()) {
+            c = value[++i];
+            if (c == 's') {
+                c = ' ';
+            } else if (c == 't') {
+                c = '\t';
+            } else if (c == 'n') {
+                c = '\n';
+            }
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+} //namespace
+
+KdeProxySettings parseKioslaverc(std::string_view content)
+{
+    KdeProxySettings settings;
+    bool inProxyGroup = false;
+    while (!content.empty()) {
+        const size_t eol = content.find('\n');
+        const std::string_view line = _trim(content.substr(0, eol));
+        content = (eol == std::string_view::npos) ? std::string_view{} : content.substr(eol + 1);
+
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line[0] == '[') {
+            //nested groups such as [Proxy Settings][Other] are different groups
+            inProxyGroup = line.size() == kProxySettingsGroup.size() + 2 && line.back() == ']' &&
+                           line.substr(1, kProxySettingsGroup.size()) == kProxySettingsGroup;
+            continue;
+        }
+        if (!inProxyGroup) {
+            continue;
+        }
+
+        const size_t separator = line.find('=');
+        if (separator == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = _trim(line.substr(0, separator));
+        //drop option markers and locales, e.g. httpProxy[$e]
+        const size_t markers = key.find('[');
+        if (markers != std::string_view::npos) {
+            key = _trim(key.substr(0, markers));
+        }
+        const std::string_view value = _trim(line.substr(separator + 1));
+
+        if (key == "ProxyType") {
+            int type = 0;
+            for (char c : value) {
+                if (c < '0' || c > '9') {
+                    type = -1;
+                    break;
+                }
+                type = type * 10 + (c - '0');
+            }
+            if (type >= static_cast<int>(KdeProxyType::None) && type <= static_cast<int>(KdeProxyType::Environment)) {
+                settings.proxyType = static_cast<KdeProxyType>(type);
+            } else {
+                PROXY_LOG_WARNING("Unrecognized KDE proxy type");
+                settings.proxyType = KdeProxyType::None;
+            }
+        } else if (key == "httpProxy") {
+            settings.httpProxy = _unescape(value);
+        } else if (key == "httpsProxy") {
+            settings.httpsProxy = _unescape(value);
+        } else if (key == "ftpProxy") {
+            settings.ftpProxy = _unescape(value);
+        } else if (key == "socksProxy") {
+            settings.socksProxy = _unescape(value);
+        } else if (key == "NoProxyFor") {
+            settings.noProxyFor = _unescape(value);
+        } else if (key == "Proxy Config Script") {
+            settings.configScriptUrl = _unescape(value);
+        }
+    }
+    return settings;
+}
+
+std::optional<KdeProxySettings> readKioslaverc(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        PROXY_LOG_DEBUG("Unable to open %s: %d", path.c_str(), errno);
+        return std::nullopt;
+    }
+
+    std::string content;
+    struct stat st = {};
+    bool readOk = false;
+    if (fstat(fd, &st) == 0 && st.st_size <= kMaxKioslavercSize) {
+        content.resize(static_cast<size_t>(st.st_size));
+        size_t total = 0;
+        ssize_t bytesRead = 0;
+        while (total < content.size() &&
+               ((bytesRead = read(fd, &content[total], content.size() - total)) > 0 || (bytesRead < 0 && errno == EINTR))) {
+            total += bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+        }
+        content.resize(total);
+        readOk = bytesRead >= 0;
+    }
+    close(fd);
+
+    if (!readOk) {
+        PROXY_LOG_WARNING("Unable to read %s", path.c_str());
+        return std::nullopt;
+    }
+    return parseKioslaverc(content);
+}
+
+} //proxy
@@ -0,0 +1,57 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace proxy {
+
+/**
+ * @brief Values of the ProxyType key in kioslaverc
+ */
+enum class KdeProxyType
+{
+    None = 0,
+    Manual = 1,
+    ConfigScript = 2,
+    AutoDetect = 3,
+    Environment = 4
+};
+
+/**
+ * @brief The [Proxy Settings] group of kioslaverc. In Environment mode the proxy keys hold
+ *        names of environment variables instead of proxy urls.
+ */
+struct KdeProxySettings
+{
+    KdeProxyType proxyType = KdeProxyType::None;
+    std::string httpProxy;
+    std::string httpsProxy;
+    std::string ftpProxy;
+    std::string socksProxy;
+    std::string noProxyFor;
+    std::string configScriptUrl;
+};
+
+/**
+ * @brief Parses the [Proxy Settings] group of a kioslaverc file in a single pass.
+ *        Other groups, comments and unknown keys are skipped without copying.
+ * @param content the file content
+ * @return The parsed settings, keys missing from the file keep their defaults
+ */
+KdeProxySettings parseKioslaverc(std::string_view content);
+
+/**
+ * @brief Reads and parses a kioslaverc file with a single read
+ * @param path the file, usually $XDG_CONFIG_HOME/kioslaverc
+ * @return The parsed settings, or nullopt if the file could not be read
+ */
+std::optional<KdeProxySettings> readKioslaverc(const std::string &path);
+
+} //proxy
@@ -0,0 +1,71 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "LatencyTracker.hpp"
+
+#include <algorithm>
+
+namespace proxy {
+
+static std::chrono::microseconds _smooth(std::chrono::microseconds average, std::chrono::microseconds measured, double smoothing)
+{
+    const double smoothed = smoothing * static_cast<double>(measured.count()) +
+                            (1.0 - smoothing) * static_cast<double>(average.count());
+    return std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(smoothed));
+}
+
+LatencyTracker::LatencyTracker(double smoothing, size_t maxEntries) :
+    m_smoothing(std::clamp(smoothing, 0.0, 1.0)),
+    m_maxEntries(std::max<size_t>(maxEntries, 1))
+{
+}
+
+void LatencyTracker::record(const ProxyRecord &proxy, const ProxyLatency &measured)
+{
+    std::string key = endpointKey(proxy);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        if (m_entries.size() >= m_maxEntries) {
+            m_entries.erase(std::min_element(m_entries.begin(), m_entries.end(),
+                [](const auto &lhs, const auto &rhs) { return lhs.second.lastRecorded < rhs.second.lastRecorded; }));
+        }
+        //the first measurement is the average, there is nothing to smooth it with yet
+        m_entries.emplace(std::move(key), Entry{ measured, ++m_recordCount });
+        return;
+    }
+
+    ProxyLatency &average = it->second.latency;
+    average.connect = _smooth(average.connect, measured.connect, m_smoothing);
+    average.handshake = _smooth(average.handshake, measured.handshake, m_smoothing);
+    average.firstByte = _smooth(average.firstByte, measured.firstByte, m_smoothing);
+    average.score = _smooth(average.score, measured.score, m_smoothing);
+    it->second.lastRecorded = ++m_recordCount;
+}
+
+std::optional<ProxyLatency> LatencyTracker::latency(const ProxyRecord &proxy) const
+{
+    const std::string key = endpointKey(proxy);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return std::nullopt;
+    }
+    return it->second.latency;
+}
+
+size_t LatencyTracker::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+std::string LatencyTracker::endpointKey(const ProxyRecord &proxy)
+{
+    return proxy.url + " " + std::to_string(proxy.port);
+}
+
+} //proxy
@@ -0,0 +1,58 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "ProxyRecord.h"
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace proxy {
+
+/**
+ * @brief Keeps an exponentially weighted moving average of the latencies measured for each proxy endpoint
+ */
+class LatencyTracker
+{
+public:
+    /**
+     * @param smoothing the weight of a new measurement, between 0 (ignored) and 1 (replaces the average)
+     * @param maxEntries the number of endpoints remembered, the oldest measured is forgotten first
+     */
+    explicit LatencyTracker(double smoothing = 0.3, size_t maxEntries = 256);
+
+    /**
+     * @brief Folds one verification's timings into the average of its endpoint
+     */
+    void record(const ProxyRecord &proxy, const ProxyLatency &measured);
+
+    /**
+     * @return The averaged latency of the proxy's endpoint, none before it was measured
+     */
+    std::optional<ProxyLatency> latency(const ProxyRecord &proxy) const;
+
+    size_t size() const;
+
+private:
+    struct Entry
+    {
+        ProxyLatency latency;
+        uint64_t lastRecorded;
+    };
+
+    static std::string endpointKey(const ProxyRecord &proxy);
+
+    double m_smoothing;
+    size_t m_maxEntries;
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    uint64_t m_recordCount = 0;
+};
+
+} //proxy
@@ -0,0 +1,258 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "PacEngine.hpp"
+#include "ProxyLoggerDef.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace proxy {
+
+namespace {
+
+std::string_view _trim(std::string_view str)
+{
+    const size_t start = str.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    const size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(start, end - start + 1);
+}
+
+std::string _to_upper(std::string_view str)
+{
+    std::string result{ str };
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return std::toupper(c); });
+    return result;
+}
+
+//"host:port" or "[v6]:port" with the port being optional
+ProxyRecord _pac_proxy(std::string_view hostPort, const std::string &scheme, uint32_t defaultPort, ProxyTypes proxyType)
+{
+    std::string_view host = hostPort;
+    uint32_t port = defaultPort;
+    const size_t colon = hostPort.rfind(':');
+    const size_t bracket = hostPort.rfind(']');
+    if (colon != std::string_view::npos && (bracket == std::string_view::npos || colon > bracket)) {
+        host = hostPort.substr(0, colon);
+        const std::string_view portStr = hostPort.substr(colon + 1);
+        uint32_t value = 0;
+        for (char c : portStr) {
+            if (!std::isdigit(static_cast<unsigned char>(c)) || value > 65535) {
+                return { "", 0, ProxyTypes::None };
+            }
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+        }
+        if (portStr.empty() || value == 0 || value > 65535) {
+            return { "", 0, ProxyTypes::None };
+        }
+        port = value;
+    }
+    if (host.empty()) {
+        return { "", 0, ProxyTypes::None };
+    }
+    return { scheme + "://" + std::string(host) + ":" + std::to_string(port), port, proxyType };
+}
+
+} //namespace
+
+std::size_t PacEngine::ResultKeyHasher::operator()(const ResultKey &key) const
+{
+    std::size_t seed = std::hash<std::string>{}(key.host);
+    seed ^= static_cast<std::size_t>(key.scriptId) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+PacEngine::PacEngine(std::shared_ptr<IPacScriptRuntime> runtime, size_t maxScripts, size_t maxResults) :
+    m_runtime(std::move(runtime)),
+    m_maxScripts(std::max<size_t>(maxScripts, 1)),
+    m_maxResults(maxResults)
+{
+}
+
+ProxyRecords PacEngine::findProxies(const std::string &script, const std::string &url)
+{
+    const size_t scriptHash = std::hash<std::string>{}(script);
+    ResultKey key{ 0, pacUrlHost(url) };
+
+    std::unique_ptr<IPacScript> compiled;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        //results are only remembered for kept scripts
+        const auto entry = findScript(script, scriptHash);
+        if (entry != m_scripts.end()) {
+            if (!entry->compiles) {
+                return {};
+            }
+            key.scriptId = entry->id;
+            const auto cached = m_resultIndex.find(key);
+            if (cached != m_resultIndex.end()) {
+                m_results.splice(m_results.begin(), m_results, cached->second);
+                return cached->second->second;
+            }
+            compiled = std::move(entry->idle);
+        }
+        generation = m_generation;
+    }
+
+    //the script runs without the lock, its DNS helpers can block for seconds
+    if (!compiled) {
+        compiled = m_runtime ? m_runtime->compile(script) : nullptr;
+        if (!compiled) {
+            PROXY_LOG_ERROR("Could not compile PAC script");
+        }
+    }
+    std::optional<std::string> result;
+    if (compiled) {
+        result = compiled->findProxyForUrl(url, key.host);
+        if (!result) {
+            PROXY_LOG_ERROR("FindProxyForURL failed for host %s", key.host.c_str());
+        } else {
+            PROXY_LOG_DEBUG("FindProxyForURL returned \"%s\" for host %s", result->c_str(), key.host.c_str());
+        }
+    }
+    ProxyRecords proxies = result ? parsePacResult(*result) : ProxyRecords{};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation != m_generation) {
+        return proxies;
+    }
+    key.scriptId = storeScript(script, scriptHash, std::move(compiled));
+    if (result) {
+        storeResult(std::move(key), proxies);
+    }
+    return proxies;
+}
+
+void PacEngine::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scripts.clear();
+    m_resultIndex.clear();
+    m_results.clear();
+    ++m_generation;
+}
+
+size_t PacEngine::compiledScripts() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_scripts.size();
+}
+
+size_t PacEngine::cachedResults() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_results.size();
+}
+
+std::list<PacEngine::ScriptEntry>::iterator PacEngine::findScript(const std::string &script, size_t scriptHash)
+{
+    //the hash only skips the comparison of sources that differ, colliding scripts get entries of their own
+    const auto it = std::find_if(m_scripts.begin(), m_scripts.end(), [&script, scriptHash](const ScriptEntry &entry) {
+        return entry.sourceHash == scriptHash && entry.source == script;
+    });
+    if (it != m_scripts.end()) {
+        m_scripts.splice(m_scripts.begin(), m_scripts, it);
+    }
+    return it;
+}
+
+uint64_t PacEngine::storeScript(const std::string &script, size_t scriptHash, std::unique_ptr<IPacScript> compiled)
+{
+    const auto it = findScript(script, scriptHash);
+    if (it != m_scripts.end()) {
+        //a copy compiled while the script was in use is dropped
+        if (it->compiles && !it->idle) {
+            it->idle = std::move(compiled);
+        }
+        return it->id;
+    }
+    if (m_scripts.size() >= m_maxScripts) {
+        m_scripts.pop_back();
+    }
+    const bool compiles = compiled != nullptr;
+    m_scripts.push_front(ScriptEntry{ m_nextScriptId++, scriptHash, script, compiles, std::move(compiled) });
+    return m_scripts.front().id;
+}
+
+void PacEngine::storeResult(ResultKey key, const ProxyRecords &proxies)
+{
+    if (m_maxResults == 0) {
+        return;
+    }
+    if (m_results.size() >= m_maxResults) {
+        m_resultIndex.erase(m_results.back().first);
+        m_results.pop_back();
+    }
+    m_results.emplace_front(key, proxies);
+    m_resultIndex.emplace(std::move(key), m_results.begin());
+}
+
+ProxyRecords parsePacResult(std::string_view result)
+{
+    ProxyRecords proxies;
+    while (!result.empty()) {
+        const size_t separator = result.find(';');
+        const std::string_view entry = _trim(result.substr(0, separator));
+        result = (separator == std::string_view::npos) ? std::string_view{} : result.substr(separator + 1);
+        if (entry.empty()) {
+            continue;
+        }
+
+        const size_t space = entry.find_first_of(" \t");
+        const std::string type = _to_upper(entry.substr(0, space));
+        const std::string_view hostPort = (space == std::string_view::npos) ? std::string_view{} : _trim(entry.substr(space));
+
+        ProxyRecord proxy{ "", 0, ProxyTypes::None };
+        if (type == "DIRECT") {
+            continue;
+        } else if (type == "PROXY" || type == "HTTP") {
+            proxy = _pac_proxy(hostPort, "http", 80, ProxyTypes::HTTP);
+        } else if (type == "HTTPS") {
+            proxy = _pac_proxy(hostPort, "https", 443, ProxyTypes::HTTPS);
+        } else if (type == "SOCKS" || type == "SOCKS5") {
+            proxy = _pac_proxy(hostPort, "socks5", 1080, ProxyTypes::SOCKS);
+        } else if (type == "SOCKS4") {
+            proxy = _pac_proxy(hostPort, "socks4", 1080, ProxyTypes::SOCKS);
+        }
+
+        if (proxy.proxyType == ProxyTypes::None) {
+            PROXY_LOG_WARNING("Skipping invalid PAC proxy entry \"%s\"", std::string(entry).c_str());
+            continue;
+        }
+        proxies.push_back(std::move(proxy));
+    }
+    return proxies;
+}
+
+std::string pacUrlHost(std::string_view url)
+{
+    size_t start = url.find("://");
+    start = (start == std::string_view::npos) ? 0 : start + 3;
+    std::string_view authority = url.substr(start);
+    authority = authority.substr(0, authority.find_first_of("/?#"));
+    const size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority.remove_prefix(at + 1);
+    }
+
+    std::string_view host;
+    if (!authority.empty() && authority.front() == '[') {
+        host = authority.substr(1, authority.find(']') - 1);
+    } else {
+        host = authority.substr(0, authority.find(':'));
+    }
+
+    std::string result{ host };
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return std::tolower(c); });
+    return result;
+}
+
+} //proxy
@@ -0,0 +1,131 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IPacScriptRuntime.hpp"
+#include "ProxyRecord.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace proxy {
+
+/**
+ * @brief Evaluates PAC scripts with an IPacScriptRuntime.
+ *        Each script is compiled once and its compiled context is kept for later lookups, and the proxies
+ *        found for a host are remembered per script, both in bounded least recently used caches.
+ *        FindProxyForURL is assumed to depend on the host only, so urls sharing a host share a result.
+ *        Scripts are compiled and evaluated outside the lock of the caches. A compiled script is used by one call
+ *        at a time, a call finding it in use compiles a copy of its own, so compiled scripts are not required to
+ *        be thread safe. The runtime may be asked to compile from several threads at once.
+ */
+class PacEngine
+{
+public:
+    /**
+     * @param runtime the interpreter used to compile scripts
+     * @param maxScripts the maximum number of compiled scripts kept, at least one
+     * @param maxResults the maximum number of remembered (script, host) results
+     */
+    explicit PacEngine(std::shared_ptr<IPacScriptRuntime> runtime, size_t maxScripts = 4, size_t maxResults = 512);
+
+    /**
+     * @brief Runs FindProxyForURL of the script for the url
+     * @param script the PAC script source
+     * @param url the url to find proxies for
+     * @return The proxies in the order the script returned them, DIRECT entries are skipped.
+     *         Empty if the script could not be compiled or evaluated.
+     */
+    ProxyRecords findProxies(const std::string &script, const std::string &url);
+
+    /**
+     * @brief Drops all compiled scripts and remembered results
+     */
+    void clear();
+
+    /**
+     * @return The number of compiled scripts kept, including scripts that failed to compile
+     */
+    size_t compiledScripts() const;
+
+    /**
+     * @return The number of remembered (script, host) results
+     */
+    size_t cachedResults() const;
+
+private:
+    struct ResultKey
+    {
+        uint64_t scriptId;
+        std::string host;
+
+        bool operator ==(const ResultKey &rhs) const
+        {
+            return (scriptId == rhs.scriptId) && (host == rhs.host);
+        }
+    };
+
+    struct ResultKeyHasher
+    {
+        std::size_t operator()(const ResultKey &key) const;
+    };
+
+    using ResultList = std::list<std::pair<ResultKey, ProxyRecords>>;
+
+    struct ScriptEntry
+    {
+        //identifies the script in result keys, ids are not reused
+        uint64_t id;
+        size_t sourceHash;
+        std::string source;
+        //false when the script failed to compile, it is not compiled again
+        bool compiles;
+        //null while a call evaluates it
+        std::unique_ptr<IPacScript> idle;
+    };
+
+    //called with m_mutex held
+    std::list<ScriptEntry>::iterator findScript(const std::string &script, size_t scriptHash);
+    //returns the id of the script's entry
+    uint64_t storeScript(const std::string &script, size_t scriptHash, std::unique_ptr<IPacScript> compiled);
+    void storeResult(ResultKey key, const ProxyRecords &proxies);
+
+    std::shared_ptr<IPacScriptRuntime> m_runtime;
+    size_t m_maxScripts;
+    size_t m_maxResults;
+    mutable std::mutex m_mutex;
+    //most recently used first
+    std::list<ScriptEntry> m_scripts;
+    ResultList m_results;
+    std::unordered_map<ResultKey, ResultList::iterator, ResultKeyHasher> m_resultIndex;
+    //bumped by clear() so calls running across it do not store what they compiled or found
+    uint64_t m_generation = 0;
+    uint64_t m_nextScriptId = 0;
+};
+
+/**
+ * @brief Parses a FindProxyForURL result such as "PROXY a:8080; SOCKS b:1080; DIRECT"
+ * @param result the string returned by FindProxyForURL
+ * @return The proxies in the order listed. PROXY and HTTP become HTTP records, HTTPS becomes an HTTPS record,
+ *         SOCKS, SOCKS4 and SOCKS5 become SOCKS records. DIRECT and malformed entries are skipped.
+ */
+ProxyRecords parsePacResult(std::string_view result);
+
+/**
+ * @brief Extracts the host FindProxyForURL is called with from a url, without userinfo, port or brackets
+ * @param url the url, e.g. "https://user@[::1]:8443/path"
+ * @return The host, e.g. "::1", lower case
+ */
+std::string pacUrlHost(std::string_view url);
+
+} //proxy
@@ -0,0 +1,341 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "PacFetcher.hpp"
+#include "ProxyLoggerDef.hpp"
+#include "ProxyMetricsDef.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <strings.h>
+#include <unistd.h>
+
+namespace proxy {
+
+namespace {
+
+//PAC scripts are tens of kilobytes, anything this large is not one
+const size_t kMaxScriptSize = 4 * 1024 * 1024;
+
+struct ResponseHeaders
+{
+    std::string etag;
+    std::string lastModified;
+};
+
+size_t _append_body(char *data, size_t size, size_t count, void *userdata)
+{
+    auto *body = static_cast<std::string*>(userdata);
+    const size_t length = size * count;
+    if (body->size() + length > kMaxScriptSize) {
+        PROXY_LOG_ERROR("PAC script exceeds %zu bytes, aborting download", kMaxScriptSize);
+        return 0;
+    }
+    body->append(data, length);
+    return length;
+}
+
+size_t _store_header(char *data, size_t size, size_t count, void *userdata)
+{
+    auto *headers = static_cast<ResponseHeaders*>(userdata);
+    const size_t length = size * count;
+    std::string_view line{ data, length };
+    if (line.rfind("HTTP/", 0) == 0) {
+        //a new response after a redirect, forget the headers of the previous one
+        *headers = ResponseHeaders{};
+        return length;
+    }
+
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) {
+        return length;
+    }
+    const std::string_view name = line.substr(0, colon);
+    std::string_view value = line.substr(colon + 1);
+    const size_t start = value.find_first_not_of(" \t");
+    const size_t end = value.find_last_not_of(" \t\r\n");
+    value = (start == std::string_view::npos) ? std::string_view{} : value.substr(start, end - start + 1);
+
+    if (name.size() == 4 && strncasecmp(name.data(), "etag", 4) == 0) {
+        headers->etag = value;
+    } else if (name.size() == 13 && strncasecmp(name.data(), "last-modified", 13) == 0) {
+        headers->lastModified = value;
+    }
+    return length;
+}
+
+//FNV-1a, stable between processes and builds unlike std::hash
+std::string _url_digest(const std::string &url)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : url) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char digest[17];
+    std::snprintf(digest, sizeof(digest), "%016llx", static_cast<unsigned long long>(hash));
+    return digest;
+}
+
+} //namespace
+
+PacFetcher::PacFetcher(std::string cacheDirectory, std::chrono::seconds maxAge, std::chrono::milliseconds fetchTimeout) :
+    m_cacheDirectory(std::move(cacheDirectory)),
+    m_maxAge(maxAge),
+    m_fetchTimeout(fetchTimeout)
+{
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    m_handlePool = std::make_unique<CurlHandlePool>(2);
+}
+
+PacFetcher::~PacFetcher()
+{
+    waitRevalidations();
+    m_handlePool.reset();
+    curl_global_cleanup();
+}
+
+std::optional<std::string> PacFetcher::fetchScript(const std::string &url)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_scripts.find(url);
+    if (it == m_scripts.end()) {
+        lock.unlock();
+        auto stored = readCacheFile(url);
+        lock.lock();
+        if (stored) {
+            PROXY_LOG_DEBUG("Loaded cached PAC script for %s", url.c_str());
+            it = m_scripts.emplace(url, std::move(*stored)).first;
+        }
+    }
+
+    countCacheLookup("pac", it != m_scripts.end());
+    if (it != m_scripts.end()) {
+        const auto now = std::chrono::system_clock::now();
+        const auto fetchedAt = it->second.fetchedAt;
+        if ((now - fetchedAt >= m_maxAge || fetchedAt > now) && m_revalidating.insert(url).second) {
+            if (m_revalidating.size() == 1) {
+                //nothing else is being revalidated, so every earlier thread has finished
+                for (auto &thread : m_revalidations) {
+                    thread.join();
+                }
+                m_revalidations.clear();
+            }
+            m_revalidations.emplace_back(&PacFetcher::revalidate, this, url);
+        }
+        return it->second.script;
+    }
+    lock.unlock();
+
+    CachedScript entry;
+    if (download(url, entry) != FetchResult::Modified) {
+        return std::nullopt;
+    }
+    entry.fetchedAt = std::chrono::system_clock::now();
+    writeCacheFile(url, entry);
+
+    lock.lock();
+    m_scripts[url] = entry;
+    return entry.script;
+}
+
+void PacFetcher::waitRevalidations()
+{
+    std::vector<std::thread> revalidations;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        revalidations.swap(m_revalidations);
+    }
+    for (auto &thread : revalidations) {
+        thread.join();
+    }
+}
+
+void PacFetcher::revalidate(const std::string &url)
+{
+    CachedScript entry;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entry = m_scripts[url];
+    }
+
+    const FetchResult result = download(url, entry);
+    //a failed attempt is also not repeated before maxAge passes, the cached copy stays in use meanwhile
+    entry.fetchedAt = std::chrono::system_clock::now();
+    if (result == FetchResult::Failed) {
+        PROXY_LOG_WARNING("Could not revalidate PAC script %s, using the cached copy", url.c_str());
+    } else {
+        PROXY_LOG_DEBUG("PAC script %s %s", url.c_str(), result == FetchResult::Modified ? "changed" : "not modified");
+        writeCacheFile(url, entry);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scripts[url] = std::move(entry);
+    m_revalidating.erase(url);
+}
+
+PacFetcher::FetchResult PacFetcher::download(const std::string &url, CachedScript &entry)
+{
+    CurlHandlePool::Handle curl = m_handlePool->acquire();
+    if (!curl) {
+        PROXY_LOG_ERROR("curl_easy_init failed for PAC script %s", url.c_str());
+        return FetchResult::Failed;
+    }
+
+    std::string body;
+    ResponseHeaders headers;
+    curl_slist *requestHeaders = nullptr;
+    if (!entry.etag.empty()) {
+        requestHeaders = curl_slist_append(requestHeaders, ("If-None-Match: " + entry.etag).c_str());
+    }
+    if (!entry.lastModified.empty()) {
+        requestHeaders = curl_slist_append(requestHeaders, ("If-Modified-Since: " + entry.lastModified).c_str());
+    }
+
+    const std::string caPath = caBundlePath();
+    curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    //the script tells which proxies to use, it is always fetched directly
+    curl_easy_setopt(curl.get(), CURLOPT_NOPROXY, "*");
+    curl_easy_setopt(curl.get(), CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl.get(), CURLOPT_MAXREDIRS, 5L);
+    curl_easy_setopt(curl.get(), CURLOPT_ACCEPT_ENCODING, "");
+    limitTransfer(curl.get(), m_fetchTimeout);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, &_append_body);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl.get(), CURLOPT_HEADERFUNCTION, &_store_header);
+    curl_easy_setopt(curl.get(), CURLOPT_HEADERDATA, &headers);
+    curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, requestHeaders);
+    if (!caPath.empty()) {
+        curl_easy_setopt(curl.get(), CURLOPT_CAINFO, caPath.c_str());
+    }
+
+    const CURLcode res = curl_easy_perform(curl.get());
+    long status = 0;
+    curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &status);
+    //the handle must not point at the header list once it is freed
+    curl.reset();
+    curl_slist_free_all(requestHeaders);
+
+    if (res != CURLE_OK) {
+        PROXY_LOG_ERROR("Downloading PAC script %s failed: %s", url.c_str(), curl_easy_strerror(res));
+        return FetchResult::Failed;
+    }
+    if (status == 304 && !entry.script.empty()) {
+        if (!headers.etag.empty()) {
+            entry.etag = std::move(headers.etag);
+        }
+        if (!headers.lastModified.empty()) {
+            entry.lastModified = std::move(headers.lastModified);
+        }
+        return FetchResult::NotModified;
+    }
+    if (status != 200) {
+        PROXY_LOG_ERROR("Downloading PAC script %s failed with HTTP status %ld", url.c_str(), status);
+        return FetchResult::Failed;
+    }
+
+    entry.script = std::move(body);
+    entry.etag = std::move(headers.etag);
+    entry.lastModified = std::move(headers.lastModified);
+    return FetchResult::Modified;
+}
+
+std::string PacFetcher::cacheFilePath(const std::string &url) const
+{
+    return m_cacheDirectory + "/" + _url_digest(url) + ".pac";
+}
+
+//the cache file holds "key value" lines, an empty line and the script
+std::optional<PacFetcher::CachedScript> PacFetcher::readCacheFile(const std::string &url) const
+{
+    if (m_cacheDirectory.empty()) {
+        return std::nullopt;
+    }
+    std::ifstream file(cacheFilePath(url), std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    CachedScript entry;
+    std::string cachedUrl;
+    long long fetchedAt = 0;
+    std::string line;
+    while (std::getline(file, line) && !line.empty()) {
+        const size_t space = line.find(' ');
+        const std::string key = line.substr(0, space);
+        const std::string value = (space == std::string::npos) ? "" : line.substr(space + 1);
+        if (key == "url") {
+            cachedUrl = value;
+        } else if (key == "etag") {
+            entry.etag = value;
+        } else if (key == "last-modified") {
+            entry.lastModified = value;
+        } else if (key == "fetched-at") {
+            fetchedAt = std::strtoll(value.c_str(), nullptr, 10);
+        }
+    }
+    if (cachedUrl != url) {
+        //digest collision or a damaged file
+        return std::nullopt;
+    }
+
+    std::ostringstream script;
+    script << file.rdbuf();
+    entry.script = script.str();
+    entry.fetchedAt = std::chrono::system_clock::time_point(std::chrono::seconds(fetchedAt));
+    return entry;
+}
+
+void PacFetcher::writeCacheFile(const std::string &url, const CachedScript &entry) const
+{
+    if (m_cacheDirectory.empty()) {
+        return;
+    }
+    std::error_code ec;
+    if (std::filesystem::create_directories(m_cacheDirectory, ec)) {
+        std::filesystem::permissions(m_cacheDirectory, std::filesystem::perms::owner_all, ec);
+    }
+
+    //written next to the cache file and renamed over it, readers in other processes never see half a file
+    const std::string path = cacheFilePath(url);
+    std::string tempPath = path + ".XXXXXX";
+    const int fd = mkstemp(tempPath.data());
+    if (fd < 0) {
+        PROXY_LOG_WARNING("Could not create a PAC cache file in %s", m_cacheDirectory.c_str());
+        return;
+    }
+
+    const auto fetchedAt = std::chrono::duration_cast<std::chrono::seconds>(entry.fetchedAt.time_since_epoch()).count();
+    const std::string content = "url " + url + "\n"
+                                "etag " + entry.etag + "\n"
+                                "last-modified " + entry.lastModified + "\n"
+                                "fetched-at " + std::to_string(fetchedAt) + "\n"
+                                "\n" + entry.script;
+    size_t written = 0;
+    while (written < content.size()) {
+        const ssize_t n = write(fd, content.data() + written, content.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    close(fd);
+
+    if (written != content.size() || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        PROXY_LOG_WARNING("Could not write PAC cache file %s", path.c_str());
+        unlink(tempPath.c_str());
+    }
+}
+
+} //proxy
@@ -0,0 +1,89 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IPacFetcher.hpp"
+#include "CurlHandlePool.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief Downloads PAC scripts with libcurl and keeps them, with their ETag and Last-Modified values,
+ *        in memory and in a cache directory shared between processes.
+ *        A cached script is returned right away. Once it is older than maxAge it is revalidated in the
+ *        background with If-None-Match/If-Modified-Since, so a slow or unreachable server never delays
+ *        discovery and the cached copy keeps being served until the server answers.
+ *        Only a script that was never fetched is downloaded while the caller waits.
+ */
+class PacFetcher : public IPacFetcher
+{
+public:
+    /**
+     * @param cacheDirectory where fetched scripts are stored, empty to keep them in memory only
+     * @param maxAge how long a fetched script is used before it is revalidated
+     * @param fetchTimeout upper bound for a single download
+     */
+    explicit PacFetcher(std::string cacheDirectory, std::chrono::seconds maxAge = std::chrono::minutes(5),
+                        std::chrono::milliseconds fetchTimeout = std::chrono::seconds(10));
+    ~PacFetcher();
+    PacFetcher(const PacFetcher&) = delete;
+    PacFetcher& operator = (const PacFetcher&) = delete;
+
+    std::optional<std::string> fetchScript(const std::string &url) override;
+
+    /**
+     * @brief Blocks until the background revalidations started so far have finished
+     */
+    void waitRevalidations();
+
+private:
+    struct CachedScript
+    {
+        std::string script;
+        std::string etag;
+        std::string lastModified;
+        std::chrono::system_clock::time_point fetchedAt;
+    };
+
+    enum class FetchResult
+    {
+        Modified,
+        NotModified,
+        Failed
+    };
+
+    /**
+     * @brief Downloads url, conditionally when entry holds validators. On Modified the script and
+     *        validators of entry are replaced, on NotModified entry keeps its script.
+     */
+    FetchResult download(const std::string &url, CachedScript &entry);
+    void revalidate(const std::string &url);
+    std::string cacheFilePath(const std::string &url) const;
+    std::optional<CachedScript> readCacheFile(const std::string &url) const;
+    void writeCacheFile(const std::string &url, const CachedScript &entry) const;
+
+    std::string m_cacheDirectory;
+    std::chrono::seconds m_maxAge;
+    std::chrono::milliseconds m_fetchTimeout;
+    std::unique_ptr<CurlHandlePool> m_handlePool;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, CachedScript> m_scripts;
+    std::unordered_set<std::string> m_revalidating;
+    std::vector<std::thread> m_revalidations;
+};
+
+} //proxy
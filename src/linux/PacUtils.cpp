@@ -0,0 +1,217 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "PacUtils.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace proxy {
+
+namespace {
+
+const char kPacUtilsScript[] = R"js(
+function dnsDomainIs(host, domain) {
+    return host.length >= domain.length &&
+           host.substring(host.length - domain.length) == domain;
+}
+
+function dnsDomainLevels(host) {
+    return host.split('.').length - 1;
+}
+
+function isPlainHostName(host) {
+    return host.indexOf('.') == -1;
+}
+
+function localHostOrDomainIs(host, hostdom) {
+    return host == hostdom || hostdom.lastIndexOf(host + '.', 0) == 0;
+}
+
+function isResolvable(host) {
+    return dnsResolve(host) != null;
+}
+
+function _isIpv4Address(str) {
+    return /^\d{1,3}\.\d{1,3}\.\d{1,3}\.\d{1,3}$/.test(str);
+}
+
+function _ipv4ToNumber(str) {
+    var bytes = str.split('.');
+    return ((bytes[0] & 0xff) << 24) | ((bytes[1] & 0xff) << 16) |
+           ((bytes[2] & 0xff) << 8) | (bytes[3] & 0xff);
+}
+
+function isInNet(host, pattern, mask) {
+    var address = _isIpv4Address(host) ? host : dnsResolve(host);
+    if (address == null || !_isIpv4Address(pattern) || !_isIpv4Address(mask)) {
+        return false;
+    }
+    var maskBits = _ipv4ToNumber(mask);
+    return (_ipv4ToNumber(address) & maskBits) == (_ipv4ToNumber(pattern) & maskBits);
+}
+
+function shExpMatch(str, pattern) {
+    var expression = pattern.replace(/[.+^${}()|[\]\\]/g, '\\$&')
+                            .replace(/\*/g, '.*')
+                            .replace(/\?/g, '.');
+    return new RegExp('^' + expression + '$').test(str);
+}
+
+var _weekdays = { SUN: 0, MON: 1, TUE: 2, WED: 3, THU: 4, FRI: 5, SAT: 6 };
+var _months = { JAN: 0, FEB: 1, MAR: 2, APR: 3, MAY: 4, JUN: 5, JUL: 6, AUG: 7, SEP: 8, OCT: 9, NOV: 10, DEC: 11 };
+
+function _inRange(from, value, to) {
+    return from <= to ? from <= value && value <= to : value >= from || value <= to;
+}
+
+function weekdayRange() {
+    var args = Array.prototype.slice.call(arguments);
+    var useGmt = args.length > 0 && args[args.length - 1] == 'GMT';
+    if (useGmt) {
+        args.pop();
+    }
+    if (args.length < 1 || !(args[0] in _weekdays) || (args.length > 1 && !(args[1] in _weekdays))) {
+        return false;
+    }
+    var now = new Date();
+    var today = useGmt ? now.getUTCDay() : now.getDay();
+    var from = _weekdays[args[0]];
+    var to = args.length > 1 ? _weekdays[args[1]] : from;
+    return _inRange(from, today, to);
+}
+
+function dateRange() {
+    var args = Array.prototype.slice.call(arguments);
+    var useGmt = args.length > 0 && args[args.length - 1] == 'GMT';
+    if (useGmt) {
+        args.pop();
+    }
+    if (args.length < 1 || args.length > 6 || (args.length > 1 && args.length % 2 != 0)) {
+        return false;
+    }
+
+    var now = new Date();
+    var today = {
+        day: useGmt ? now.getUTCDate() : now.getDate(),
+        month: useGmt ? now.getUTCMonth() : now.getMonth(),
+        year: useGmt ? now.getUTCFullYear() : now.getFullYear()
+    };
+
+    // each argument is a day of month (1-31), a month name or a four digit year
+    function fieldOf(arg) {
+        if (typeof arg == 'string' && arg in _months) {
+            return 'month';
+        }
+        return arg > 31 ? 'year' : 'day';
+    }
+    function valueOf(arg) {
+        return fieldOf(arg) == 'month' ? _months[arg] : Number(arg);
+    }
+
+    if (args.length == 1) {
+        return today[fieldOf(args[0])] == valueOf(args[0]);
+    }
+
+    // both bounds name the same fields, compare the date reduced to those fields
+    var half = args.length / 2;
+    var from = 0, to = 0, current = 0;
+    var fields = ['year', 'month', 'day'];
+    for (var i = 0; i < fields.length; ++i) {
+        for (var j = 0; j < half; ++j) {
+            if (fieldOf(args[j]) == fields[i]) {
+                from = from * 100 + valueOf(args[j]);
+                to = to * 100 + valueOf(args[j + half]);
+                current = current * 100 + today[fields[i]];
+            }
+        }
+    }
+    return _inRange(from, current, to);
+}
+
+function timeRange() {
+    var args = Array.prototype.slice.call(arguments);
+    var useGmt = args.length > 0 && args[args.length - 1] == 'GMT';
+    if (useGmt) {
+        args.pop();
+    }
+
+    var now = new Date();
+    var current = (useGmt ? now.getUTCHours() : now.getHours()) * 3600 +
+                  (useGmt ? now.getUTCMinutes() : now.getMinutes()) * 60 +
+                  (useGmt ? now.getUTCSeconds() : now.getSeconds());
+    switch (args.length) {
+    case 1:
+        return Math.floor(current / 3600) == Number(args[0]);
+    case 2:
+        return _inRange(args[0] * 3600, current, args[1] * 3600 + 3599);
+    case 4:
+        return _inRange(args[0] * 3600 + args[1] * 60, current, args[2] * 3600 + args[3] * 60 + 59);
+    case 6:
+        return _inRange(args[0] * 3600 + args[1] * 60 + Number(args[2]), current,
+                        args[3] * 3600 + args[4] * 60 + Number(args[5]));
+    default:
+        return false;
+    }
+}
+)js";
+
+} //namespace
+
+std::string_view pacUtilsScript()
+{
+    return { kPacUtilsScript, sizeof(kPacUtilsScript) - 1 };
+}
+
+std::string pacDnsResolve(const std::string &host)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    if (host.empty() || getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || result == nullptr) {
+        return "";
+    }
+
+    char address[INET_ADDRSTRLEN] = {};
+    const auto *ipv4 = reinterpret_cast<const sockaddr_in *>(result->ai_addr);
+    const bool converted = inet_ntop(AF_INET, &ipv4->sin_addr, address, sizeof(address)) != nullptr;
+    freeaddrinfo(result);
+    return converted ? address : "";
+}
+
+std::string pacMyIpAddress()
+{
+    const std::string loopback{ "127.0.0.1" };
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return loopback;
+    }
+
+    //connecting a datagram socket only selects the route and the source address
+    sockaddr_in remote{};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(53);
+    inet_pton(AF_INET, "198.51.100.1", &remote.sin_addr);
+
+    sockaddr_in local{};
+    socklen_t localLength = sizeof(local);
+    std::string address = loopback;
+    if (connect(fd, reinterpret_cast<const sockaddr *>(&remote), sizeof(remote)) == 0 &&
+        getsockname(fd, reinterpret_cast<sockaddr *>(&local), &localLength) == 0) {
+        char buffer[INET_ADDRSTRLEN] = {};
+        if (inet_ntop(AF_INET, &local.sin_addr, buffer, sizeof(buffer)) != nullptr) {
+            address = buffer;
+        }
+    }
+    close(fd);
+    return address;
+}
+
+} //proxy
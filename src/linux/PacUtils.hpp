@@ -0,0 +1,35 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace proxy {
+
+/**
+ * @brief JavaScript definitions of the standard PAC helper functions (dnsDomainIs, isInNet, shExpMatch,
+ *        weekdayRange, ...). A script runtime evaluates it before the PAC script and provides the native
+ *        dnsResolve(host) and myIpAddress() functions the helpers rely on.
+ */
+std::string_view pacUtilsScript();
+
+/**
+ * @brief Native implementation of the PAC dnsResolve function
+ * @param host the host name or address to resolve
+ * @return The first IPv4 address of the host in dotted form, or an empty string if it does not resolve
+ */
+std::string pacDnsResolve(const std::string &host);
+
+/**
+ * @brief Native implementation of the PAC myIpAddress function. No packets are sent, the address is the
+ *        one the routing table picks for outgoing traffic.
+ * @return The IPv4 address of this machine, or "127.0.0.1" if it has no route
+ */
+std::string pacMyIpAddress();
+
+} //proxy
@@ -6,33 +6,164 @@
 
 #include "ProxyCommandExec.hpp"
 #include "ProxyLoggerDef.hpp"
+#include "ProxyMetricsDef.hpp"
+#include "ProxyTracer.hpp"
+#include "CancellationToken.hpp"
+#include <algorithm>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 #include <spawn.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/eventfd.h>
 #include <sys/wait.h>
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <memory>
 
+namespace {
+
+//how long a command gets to exit after SIGTERM before it is sent SIGKILL
+constexpr std::chrono::milliseconds kill_grace_period{500};
+//how often the command is checked for exit while its output is still open
+constexpr std::chrono::milliseconds exit_check_interval{50};
+constexpr size_t read_chunk_size = 16 * 1024;
+//the most output reserved before a command runs, larger outputs grow the buffer as they are read
+constexpr size_t max_reserved_output = 1024 * 1024;
+
+//reads everything available on a non-blocking descriptor into the buffer, false once the descriptor is at end of file
+bool _drain(int fd, std::string &buffer)
+{
+    char chunk[read_chunk_size];
+    for (;;) {
+        const ssize_t bytesRead = read(fd, chunk, sizeof(chunk));
+        if (bytesRead > 0) {
+            buffer.append(chunk, static_cast<size_t>(bytesRead));
+            continue;
+        }
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        return bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+//0 while the process is running, its pid once it has exited
+pid_t _try_wait(pid_t pid, int &status)
+{
+    pid_t waitPid = -1;
+    do {
+        waitPid = waitpid(pid, &status, WNOHANG);
+    } while (waitPid < 0 && errno == EINTR);
+
+    if (waitPid < 0) {
+        throw std::runtime_error("waitpid failed with error: " + std::to_string(errno));
+    }
+    return waitPid;
+}
+
+//SIGTERM, then SIGKILL once the grace period is over, and reaps the process
+void _terminate(pid_t pid)
+{
+    int status = 0;
+    (void)kill(pid, SIGTERM);
+    const auto killAt = std::chrono::steady_clock::now() + kill_grace_period;
+    while (_try_wait(pid, status) == 0) {
+        if (std::chrono::steady_clock::now() >= killAt) {
+            (void)kill(pid, SIGKILL);
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            }
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+//an eventfd that becomes readable when the request is cancelled, so waiting for the command wakes up at once
+class CancelWakeup
+{
+public:
+    explicit CancelWakeup(proxy::CancellationToken *token) : m_token(token)
+    {
+        if (!m_token) {
+            return;
+        }
+        m_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (m_fd == -1) {
+            //the cancellation is still noticed with the exit checks
+            return;
+        }
+        const int fd = m_fd;
+        m_hook = m_token->addHook([fd]() {
+            const uint64_t one = 1;
+            const ssize_t written = write(fd, &one, sizeof(one));
+            (void)written;
+        });
+    }
+    ~CancelWakeup()
+    {
+        if (m_hook) {
+            m_token->removeHook(*m_hook);
+        }
+        if (m_fd != -1) {
+            (void)close(m_fd);
+        }
+    }
+    CancelWakeup(const CancelWakeup&) = delete;
+    CancelWakeup& operator = (const CancelWakeup&) = delete;
+
+    //-1 without a token, poll ignores it then
+    int fd() const
+    {
+        return m_fd;
+    }
+
+private:
+    proxy::CancellationToken *m_token;
+    int m_fd = -1;
+    std::optional<size_t> m_hook;
+};
+
+} //namespace
+
+ProxyCommandExec::ProxyCommandExec(std::chrono::milliseconds timeout, bool captureStderr) :
+    m_timeout(timeout), m_captureStderr(captureStderr)
+{
+}
+
 CommandOutput ProxyCommandExec::ExecuteCommandCaptureOutput(const std::string &cmd, const std::vector<std::string> &argv) {
+    return ExecuteCommandCaptureOutput(cmd, argv, std::chrono::steady_clock::now() + m_timeout);
+}
+
+CommandOutput ProxyCommandExec::ExecuteCommandCaptureOutput(const std::string &cmd, const std::vector<std::string> &argv,
+                                                            std::chrono::steady_clock::time_point deadline) {
     int status = 1;
     pid_t pid = -1;
-    pid_t waitPid = -1;
     extern char **environ;
     posix_spawn_file_actions_t childFdActions = {0};
     int out [2] = {-1, -1};
-    ssize_t bytesRead = 0;
-    const int waitPidOptions = 0;   
+    int err [2] = {-1, -1};
 
     if (cmd.empty() || argv.empty()) {
         throw std::runtime_error("missing arguments");
     }
+    //labelled with the program name, not its arguments, to keep the number of series small
+    proxy::ScopedMetricTimer timer(proxy::PROXY_METRIC_COMMAND, "command", cmd.substr(cmd.find_last_of('/') + 1));
+    proxy::TraceSpan span("command", cmd);
 
     if ('/' != cmd[0]) {
         throw std::runtime_error("command must be an absolute path");
     }                                                                   
 
+    // a command run for a discovery request ends with the request
+    proxy::CancellationToken *token = proxy::CancellationToken::current();
+    if (token) {
+        deadline = token->limitDeadline(deadline);
+    }
+
     if (posix_spawn_file_actions_init(&childFdActions) != 0) {
         throw std::runtime_error("posix_spawn_file_actions_init failed");
     }
@@ -55,22 +186,30 @@ CommandOutput ProxyCommandExec::ExecuteCommandCaptureOutput(const std::string &c
     };
 
     auto outPtr = std::unique_ptr<int, decltype(close_pipe)>(out, close_pipe); // Just for cleaning purpose on return.
+    auto errPtr = std::unique_ptr<int, decltype(close_pipe)>(err, close_pipe);
 
-    if (pipe(out) == -1) {
+    // close-on-exec keeps the pipes out of any other process spawned concurrently, dup2 clears it on the child's copy
+    if (pipe2(out, O_CLOEXEC) == -1) {
         throw std::runtime_error("pipe failed");
     }
 
-    int flags = fcntl(out[0], F_GETFL, 0); 
-    if (flags == -1) {
-        throw std::runtime_error("fcntl failed");
+    if (posix_spawn_file_actions_adddup2(&childFdActions, out[1], STDOUT_FILENO) != 0) {
+        throw std::runtime_error("posix_spawn_file_actions_adddup2");
     }
 
-    if (posix_spawn_file_actions_adddup2(&childFdActions, out[1], 1) != 0) {
-        throw std::runtime_error("posix_spawn_file_actions_adddup2");
+    if (m_captureStderr) {
+        if (pipe2(err, O_CLOEXEC) == -1) {
+            throw std::runtime_error("pipe failed");
+        }
+        if (posix_spawn_file_actions_adddup2(&childFdActions, err[1], STDERR_FILENO) != 0) {
+            throw std::runtime_error("posix_spawn_file_actions_adddup2");
+        }
     }
 
-    if (posix_spawn_file_actions_addclose(&childFdActions, out[0]) != 0) {
-        throw std::runtime_error("posix_spawn_file_actions_addclose");
+    for (int fd : {out[0], err[0]}) {
+        if (fd != -1 && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) == -1) {
+            throw std::runtime_error("fcntl failed");
+        }
     }
 
     std::vector<char*> argv_cstr;
@@ -85,37 +224,73 @@ CommandOutput ProxyCommandExec::ExecuteCommandCaptureOutput(const std::string &c
 
     PROXY_LOG_DEBUG("Spawned process for cmd %s: %d", cmd.c_str(), pid);
 
-    fcntl(out[0], F_SETFL, flags | O_NONBLOCK);
+    // the write ends belong to the child now, end of file is only seen once every copy is closed
+    for (int *writeEnd : {&out[1], &err[1]}) {
+        if (*writeEnd != -1) {
+            (void)close(*writeEnd);
+            *writeEnd = -1;
+        }
+    }
 
-    do {
-        waitPid = waitpid(pid, &status, waitPidOptions);
-    } while (waitPid < 0 && errno == EINTR);
-    
-    if (waitPid < 0) {
-        throw std::runtime_error(std::string{"waitpid failed with error: %d", errno});
-    } else if (waitPid > 0) {
-        if (WIFEXITED(status)) {
-            PROXY_LOG_DEBUG("Process '%s' terminated normally: %d (exit code: %d)", cmd.c_str(), pid, WEXITSTATUS(status));
-            
-            std::string output{""};
-
-            char buffer[1024];
-            while ((bytesRead = read(out[0], buffer, sizeof(buffer) - 1)) > 0) {
-                buffer[bytesRead] = '\0';
-                output.append(buffer);
-            }                       
-
-            return { WEXITSTATUS(status), output };
-        } else if (WIFSIGNALED(status)) {
-            throw std::runtime_error("Process '" + cmd + "' terminated due to uncaught exception: " + std::to_string(pid));
-        } else if (WIFSTOPPED(status)) {
-            throw std::runtime_error("Process '" + cmd + "' stopped abnormally: " + std::to_string(pid));
-        } else {
-            throw std::runtime_error("Process '" + cmd + "' did not return: " + std::to_string(pid));
-        }
-    }
-
-    return { -1, "" };
+    std::string outBuffer;
+    outBuffer.reserve(m_outputCapacity.load(std::memory_order_relaxed));
+    std::string errBuffer;
+    CancelWakeup wakeup(token);
+    pollfd fds[3] = {{out[0], POLLIN, 0}, {err[0], POLLIN, 0}, {wakeup.fd(), POLLIN, 0}};
+    std::string *buffers[2] = {&outBuffer, &errBuffer};
+    auto idleWait = std::chrono::milliseconds(1);
+
+    while (_try_wait(pid, status) == 0) {
+        if (token && token->isCancelled()) {
+            PROXY_LOG_INFO("Request cancelled, terminating process '%s': %d", cmd.c_str(), pid);
+            _terminate(pid);
+            throw std::runtime_error("Process '" + cmd + "' cancelled: " + std::to_string(pid));
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            PROXY_LOG_ERROR("Process '%s' did not finish in time, terminating: %d", cmd.c_str(), pid);
+            _terminate(pid);
+            throw std::runtime_error("Process '" + cmd + "' timed out: " + std::to_string(pid));
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) + std::chrono::milliseconds(1);
+
+        auto wait = std::min(remaining, exit_check_interval);
+        if (fds[0].fd < 0 && fds[1].fd < 0) {
+            // output closed but the process has not exited yet, only a cancellation wakes the poll
+            wait = std::min(wait, idleWait);
+            idleWait *= 2;
+        }
+
+        const int ready = poll(fds, 3, static_cast<int>(wait.count()));
+        if (ready < 0 && errno != EINTR) {
+            _terminate(pid);
+            throw std::runtime_error("poll failed with error: " + std::to_string(errno));
+        }
+        for (size_t i = 0; ready > 0 && i < 2; ++i) {
+            if (fds[i].fd >= 0 && fds[i].revents != 0 && !_drain(fds[i].fd, *buffers[i])) {
+                fds[i].fd = -1;
+            }
+        }
+    }
+
+    // whatever the process wrote before exiting is still in the pipes
+    for (size_t i = 0; i < 2; ++i) {
+        if (fds[i].fd >= 0) {
+            (void)_drain(fds[i].fd, *buffers[i]);
+        }
+    }
+
+    m_outputCapacity.store(std::min(outBuffer.size(), max_reserved_output), std::memory_order_relaxed);
+
+    if (WIFEXITED(status)) {
+        PROXY_LOG_DEBUG("Process '%s' terminated normally: %d (exit code: %d)", cmd.c_str(), pid, WEXITSTATUS(status));
+        return { WEXITSTATUS(status), std::move(outBuffer), std::move(errBuffer) };
+    } else if (WIFSIGNALED(status)) {
+        throw std::runtime_error("Process '" + cmd + "' terminated due to uncaught exception: " + std::to_string(pid));
+    } else if (WIFSTOPPED(status)) {
+        throw std::runtime_error("Process '" + cmd + "' stopped abnormally: " + std::to_string(pid));
+    }
+    throw std::runtime_error("Process '" + cmd + "' did not return: " + std::to_string(pid));
 }
 
 std::string ProxyCommandExec::getEnvironmentVar(const std::string &name) 
@@ -125,4 +300,4 @@ std::string ProxyCommandExec::getEnvironmentVar(const std::string &name)
         return std::string(str);
     }
     return "";
-}
\ No newline at end of file
+}
@@ -8,10 +8,40 @@
 
 #include "IProxyCommandExec.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
 class  ProxyCommandExec : public IProxyCommandExec
 {
 public:
+    /**
+     * @param[in] timeout How long a command may run before it is terminated
+     * @param[in] captureStderr Capture the standard error of commands into CommandOutput::error_ instead of
+     *            letting it go to this process's standard error
+     */
+    explicit ProxyCommandExec(std::chrono::milliseconds timeout = std::chrono::seconds(5), bool captureStderr = false);
+
     CommandOutput ExecuteCommandCaptureOutput(const std::string &cmd, const std::vector<std::string> &argv) override;
 
+    /**
+     * @brief Executes a command and captures its output while it runs. A command still running at the deadline
+     *        is sent SIGTERM, then SIGKILL if it has not exited shortly after, and the call throws.
+     *        When called for a discovery request, the command is terminated the same way once the request is
+     *        cancelled or past its deadline.
+     * @param[in] cmd The command to execute, an absolute path
+     * @param[in] argv The arguments to the command
+     * @param[in] deadline When the command is terminated
+     * @return A composite type containing the exit code and the output of the command
+     */
+    CommandOutput ExecuteCommandCaptureOutput(const std::string &cmd, const std::vector<std::string> &argv,
+                                              std::chrono::steady_clock::time_point deadline);
+
     std::string getEnvironmentVar(const std::string &name) override;
-};
\ No newline at end of file
+
+private:
+    std::chrono::milliseconds m_timeout;
+    bool m_captureStderr;
+    //the size of the last command output, reserved up front for the next command as they tend to match
+    std::atomic<size_t> m_outputCapacity{ 0 };
+};
@@ -5,30 +5,69 @@
  */
 
 #include "ProxyDiscoveryEngine.hpp"
+#include "CancellationToken.hpp"
+#include "DconfDatabase.hpp"
+#include "KdeProxySettings.hpp"
+#include "ObserverRegistry.hpp"
+#include "ProxyUrl.hpp"
+#include "SettingsWatcher.hpp"
+#include "ProxyHealthMonitor.hpp"
 #include "ProxyLoggerDef.hpp"
-#include <regex>
+#include "ProxyMetricsDef.hpp"
+#include "ProxyTracer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
 
 namespace proxy {
 
-ProxyDiscoveryEngine::ProxyDiscoveryEngine(std::shared_ptr<IProxyCommandExec> commandExecutor, std::shared_ptr<IProxyVerifier> proxyVerifier) : m_commandExecutor(commandExecutor), m_proxyVerifier(proxyVerifier) {}
+ProxyDiscoveryEngine::ProxyDiscoveryEngine(std::shared_ptr<IProxyCommandExec> commandExecutor, std::shared_ptr<IProxyVerifier> proxyVerifier,
+                                           ProxyDiscoveryOptions options, std::shared_ptr<PacEngine> pacEngine,
+                                           std::shared_ptr<IPacFetcher> pacFetcher,
+                                           std::shared_ptr<IProxyVerifier> healthCheckVerifier) :
+    m_commandExecutor(commandExecutor), m_proxyVerifier(proxyVerifier), m_options(std::move(options)),
+    m_pacEngine(std::move(pacEngine)), m_pacFetcher(std::move(pacFetcher)),
+    m_observers(std::make_shared<ObserverRegistry>()) {
+    if (m_options.healthCheckInterval.count() > 0) {
+        m_healthMonitor = std::make_unique<ProxyHealthMonitor>(healthCheckVerifier ? healthCheckVerifier : m_proxyVerifier,
+            m_options.healthCheckInterval, m_options.healthCheckMaxBackoff, m_options.circuitBreakerThreshold,
+            [this]() { rediscoverLastRequest(); });
+    }
+    if (m_options.watchSettings) {
+        m_settingsWatcher = std::make_unique<SettingsWatcher>(watchedSettingsFiles(), [this]() { onSettingsChanged(); });
+        if (!m_settingsWatcher->isWatching()) {
+            PROXY_LOG_WARNING("No proxy settings files could be watched, settings changes will not be noticed");
+        }
+    }
+}
 
 ProxyDiscoveryEngine::~ProxyDiscoveryEngine() {
-    waitPrevOpCompleted();
-};
-
-//gsettings returns values surrounded by single quotes
-static void _trim_gsettings_output(std::string &output)
-{
-    size_t start = output.find_first_of("'");
-    if (start == std::string::npos) {
-        return;
+    //the monitor and the watcher queue requests, stop them before the worker
+    if (m_healthMonitor) {
+        m_healthMonitor->stop();
     }
-    size_t end = output.find_last_of("'");
-    if (start == end) {
-        return;
+    m_settingsWatcher.reset();
+    {
+        //nobody is going to wait for the outstanding requests any more
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        for (auto& request : m_pendingRequests) {
+            m_abortedRequests.emplace_back(std::move(request.complete), ProxyRequestOutcome::Cancelled);
+        }
+        m_pendingRequests.clear();
+        if (m_runningToken) {
+            m_runningToken->cancel();
+        }
+        m_stopWorker = true;
     }
-    output = output.substr(start + 1, end - start - 1);
-}
+    m_queueChanged.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+    //the worker used it until it was joined
+    m_healthMonitor.reset();
+};
 
 static std::string _construct_url(const std::string& host, const std::string& port, const std::string& protocol) {
     if (host.empty()) {
@@ -43,63 +82,316 @@ static std::string _construct_url(const std::string& host, const std::string& po
 }
 
 
-static uint32_t _get_port(const std::string& url) {
-    std::regex urlPattern{R"(^(?:https?|socks5|socks4|ftp)://[a-zA-Z0-9._-]+(?:\:\d+)$)"};
-    if (!std::regex_match(url, urlPattern)) {
-        if (url.rfind("https://", 0) == 0) {
-            return 443;
-        } else if (url.rfind("http://", 0) == 0) {
-            return 80;
-        } else if (url.rfind("socks5://", 0) == 0) {
-            return 1080;
-        } else if (url.rfind("socks4://", 0) == 0) {
-            return 1080;
-        }
-        return 0;
+static std::shared_ptr<CancellationToken> _make_token(std::optional<std::chrono::milliseconds> timeout) {
+    if (timeout) {
+        return std::make_shared<CancellationToken>(CancellationToken::Clock::now() + *timeout);
     }
-    return static_cast<uint32_t>(std::stoi(url.substr(url.find_last_of(":") + 1)));
+    return std::make_shared<CancellationToken>();
 }
 
-static bool _valid_url(const std::string& url) {
-    std::regex authenticatedUrlPattern{R"(^(https?|socks5|socks4|ftp)://[^:@]+:[^/:]+@[^/:]+(:\d+)?)"};
-    std::regex urlPattern{R"(^(?:https?|socks5|socks4|ftp)://[a-zA-Z0-9._-]+(?:\:\d+)?$)"};
-    if (std::regex_match(url, authenticatedUrlPattern)) {
+//the parts of a usable proxy url, authenticated proxies are not usable
+static std::optional<ProxyUrl> _valid_url(std::string_view url) {
+    auto parsed = parseProxyUrl(url);
+    if (parsed && !parsed->userinfo.empty()) {
         PROXY_LOG_WARNING("Authenticated proxy servers not supported");
-        return false;
-    } 
-    return std::regex_match(url, urlPattern);
+        return std::nullopt;
+    }
+    return parsed;
+}
+
+//identifies the endpoint curl actually connects to: scheme, host and the port from the url, or the record port when the url has none
+static std::string _endpoint_key(const ProxyRecord& proxy) {
+    std::string key;
+    uint32_t port = proxy.port;
+    if (const auto url = parseProxyUrl(proxy.url)) {
+        key.reserve(url->scheme.size() + url->host.size() + 10);
+        key.append(url->scheme).append("://");
+        if (url->bracketedHost) {
+            key.append("[").append(url->host).append("]");
+        } else {
+            key.append(url->host);
+        }
+        if (url->hasPort) {
+            port = url->port;
+        }
+    } else {
+        key = proxy.url;
+    }
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+    return key + ":" + std::to_string(port);
 }
 
 void ProxyDiscoveryEngine::addObserver(IProxyObserver& pObserver) {
-    m_observers.push_back(&pObserver);
+    m_observers->add(pObserver);
 }
 
-void ProxyDiscoveryEngine::requestProxiesAsync(const std::string &testUrl, const std::string &, const std::string &guid)    {
-    waitPrevOpCompleted();
-    m_thread = std::make_shared<std::thread>([this, testUrl, guid](){
-        std::list<ProxyRecord> proxySettings = getProxiesInternal();
-        proxySettings.remove_if([this, &testUrl](const ProxyRecord &proxy) { return !m_proxyVerifier->verifyProxy(testUrl, proxy); });
-        notifyObservers(proxySettings, guid);
-    });
+void ProxyDiscoveryEngine::removeObserver(IProxyObserver& pObserver) {
+    m_observers->remove(pObserver);
+}
+
+void ProxyDiscoveryEngine::requestProxiesAsync(const std::string &testUrl, const std::string &pacUrl, const std::string &guid)    {
+    requestObservedProxies(testUrl, pacUrl, guid, std::nullopt);
+}
+
+void ProxyDiscoveryEngine::requestProxiesAsync(const std::string &testUrl, const std::string &pacUrl, const std::string &guid,
+                                               std::chrono::milliseconds timeout) {
+    requestObservedProxies(testUrl, pacUrl, guid, timeout);
+}
+
+void ProxyDiscoveryEngine::requestProxiesAsync(const std::string &testUrl, const std::string &pacUrl, const std::string &guid,
+                                               std::optional<std::chrono::milliseconds> timeout, ProxyRequestCallback callback) {
+    enqueueRequest({testUrl, pacUrl, guid, _make_token(timeout), std::move(callback)});
+}
+
+void ProxyDiscoveryEngine::requestObservedProxies(const std::string &testUrl, const std::string &pacUrl, const std::string &guid,
+                                                  std::optional<std::chrono::milliseconds> timeout) {
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        m_lastTestUrl = testUrl;
+        m_lastPacUrl = pacUrl;
+        m_lastGuid = guid;
+    }
+    enqueueRequest({testUrl, pacUrl, guid, _make_token(timeout),
+        [this, guid](ProxyRecords proxies, std::optional<ProxyRequestOutcome> aborted) {
+            if (aborted) {
+                notifyAborted(guid, *aborted);
+            } else {
+                notifyObservers(proxies, guid);
+            }
+        }});
+}
+
+void ProxyDiscoveryEngine::enqueueRequest(PendingRequest request) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_worker.joinable()) {
+            m_worker = std::thread(&ProxyDiscoveryEngine::workerLoop, this);
+        }
+        if (!m_pendingRequests.empty() && m_pendingRequests.size() >= m_options.maxPendingRequests) {
+            PROXY_LOG_WARNING("Too many pending proxy requests, dropping request %s", m_pendingRequests.front().guid.c_str());
+            m_abortedRequests.emplace_back(std::move(m_pendingRequests.front().complete), ProxyRequestOutcome::Cancelled);
+            m_pendingRequests.pop_front();
+        }
+        m_pendingRequests.push_back(std::move(request));
+    }
+    m_queueChanged.notify_all();
+}
+
+void ProxyDiscoveryEngine::cancel(const std::string &guid) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        for (auto it = m_pendingRequests.begin(); it != m_pendingRequests.end(); ) {
+            if (it->guid == guid) {
+                m_abortedRequests.emplace_back(std::move(it->complete), ProxyRequestOutcome::Cancelled);
+                it = m_pendingRequests.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (m_runningToken && m_runningGuid == guid) {
+            PROXY_LOG_INFO("Cancelling running proxy request %s", guid.c_str());
+            m_runningToken->cancel();
+        }
+    }
+    m_queueChanged.notify_all();
 }
 
 void ProxyDiscoveryEngine::waitPrevOpCompleted() {
-    if (m_thread && m_thread->joinable()) {
-        //wait for the previous discovery completed.
-        m_thread->join();
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    if (std::this_thread::get_id() == m_worker.get_id()) {
+        //called by an observer, the request being notified can not finish before it returns
+        return;
     }
+    m_queueChanged.wait(lock, [this]() {
+        return m_pendingRequests.empty() && m_abortedRequests.empty() && !m_requestRunning;
+    });
 }
 
-void ProxyDiscoveryEngine::notifyObservers(const std::list<ProxyRecord> &proxies, const std::string &guid)
+void ProxyDiscoveryEngine::workerLoop() {
+    for (;;) {
+        std::optional<PendingRequest> request;
+        std::vector<std::pair<ProxyRequestCallback, ProxyRequestOutcome>> abortedRequests;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueChanged.wait(lock, [this]() {
+                return m_stopWorker || !m_pendingRequests.empty() || !m_abortedRequests.empty();
+            });
+            if (m_pendingRequests.empty() && m_abortedRequests.empty()) {
+                return;
+            }
+            abortedRequests.swap(m_abortedRequests);
+            if (!m_pendingRequests.empty()) {
+                request = std::move(m_pendingRequests.front());
+                m_pendingRequests.pop_front();
+                m_runningGuid = request->guid;
+                m_runningToken = request->token;
+            }
+            m_requestRunning = true;
+        }
+
+        for (const auto &aborted : abortedRequests) {
+            aborted.first({}, aborted.second);
+        }
+        if (request) {
+            discover(*request);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_runningToken.reset();
+            m_runningGuid.clear();
+            m_requestRunning = false;
+        }
+        m_queueChanged.notify_all();
+    }
+}
+
+void ProxyDiscoveryEngine::discover(const PendingRequest &request) {
+    TraceRequestScope traceScope(request.guid);
+    recordTraceSpan("request queued", request.testUrl, request.queuedAt, std::chrono::steady_clock::now());
+    TraceSpan span("request", request.testUrl);
+    CancellationToken &token = *request.token;
+    try {
+        CancellationToken::Scope scope(&token);
+        ProxyRecords proxySettings;
+        if (!token.stopRequested()) {
+            proxySettings = getProxiesInternal();
+        }
+        if (!token.stopRequested()) {
+            expandPacProxies(request.testUrl, request.pacUrl, proxySettings);
+        }
+        if (!token.stopRequested()) {
+            removeUnverifiedProxies(request.testUrl, proxySettings);
+            rankProxies(proxySettings);
+        }
+        //whatever ran past the end of the request was cut short, its list is not trustworthy
+        if (!token.stopRequested()) {
+            GetProxyMetrics().observeDuration(PROXY_METRIC_REQUEST, { { "kind", "async" } }, elapsedSince(request.queuedAt));
+            request.complete(std::move(proxySettings), std::nullopt);
+            return;
+        }
+    } catch (const std::exception &e) {
+        PROXY_LOG_ERROR("Proxy discovery for request %s failed: %s", request.guid.c_str(), e.what());
+        //the caller still hears of the request, an error interrupted by the stop is reported as the stop
+        if (!token.stopRequested()) {
+            request.complete({}, ProxyRequestOutcome::Failed);
+            return;
+        }
+    }
+
+    const ProxyRequestOutcome outcome = token.isCancelled() ? ProxyRequestOutcome::Cancelled : ProxyRequestOutcome::TimedOut;
+    PROXY_LOG_INFO("Proxy request %s %s", request.guid.c_str(), outcome == ProxyRequestOutcome::Cancelled ? "cancelled" : "timed out");
+    request.complete({}, outcome);
+}
+
+void ProxyDiscoveryEngine::notifyObservers(const ProxyRecords &proxies, const std::string &guid)
 {
-    for(auto* pObserver: m_observers)
     {
-        pObserver->updateProxyList(proxies, guid);
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        m_lastNotified = proxies;
+    }
+    if (!m_options.notificationExecutor) {
+        m_observers->notify([&proxies, &guid](IProxyObserver& observer) { observer.updateProxies(proxies, guid); });
+        return;
+    }
+    m_options.notificationExecutor([observers = m_observers, proxies, guid]() {
+        observers->notify([&proxies, &guid](IProxyObserver& observer) { observer.updateProxies(proxies, guid); });
+    });
+}
+
+void ProxyDiscoveryEngine::notifyAborted(const std::string &guid, ProxyRequestOutcome outcome)
+{
+    if (!m_options.notificationExecutor) {
+        m_observers->notify([&guid, outcome](IProxyObserver& observer) { observer.proxyRequestAborted(guid, outcome); });
+        return;
     }
+    m_options.notificationExecutor([observers = m_observers, guid, outcome]() {
+        observers->notify([&guid, outcome](IProxyObserver& observer) { observer.proxyRequestAborted(guid, outcome); });
+    });
+}
+
+ProxyRecords ProxyDiscoveryEngine::getProxiesInternal() {
+    TraceSpan span("getProxiesInternal");
+    if (!m_options.watchSettings) {
+        return readProxySettings();
+    }
+
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        countCacheLookup("settings", m_settingsSnapshot.has_value());
+        if (m_settingsSnapshot) {
+            return *m_settingsSnapshot;
+        }
+        generation = m_settingsGeneration;
+    }
+
+    ProxyRecords proxySettings = readProxySettings();
+    const CancellationToken *token = CancellationToken::current();
+    if (token && token->stopRequested()) {
+        //settings read by an interrupted gsettings may be incomplete, the next request reads them again
+        return proxySettings;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        //settings that changed while they were read are older than the change, the next request reads them again
+        if (generation == m_settingsGeneration) {
+            m_settingsSnapshot = proxySettings;
+        }
+    }
+    return proxySettings;
+}
+
+std::vector<std::string> ProxyDiscoveryEngine::watchedSettingsFiles() {
+    //gsettings stores its values in the dconf database, so this covers both ways of reading gnome settings
+    return { dconfDatabasePath(), kioslavercPath() };
+}
+
+void ProxyDiscoveryEngine::onSettingsChanged() {
+    //remembered gsettings output and verifications predate the change
+    m_commandExecutor->invalidate();
+    m_proxyVerifier->invalidate();
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        m_settingsSnapshot.reset();
+        ++m_settingsGeneration;
+    }
+    PROXY_LOG_INFO("Proxy settings files changed");
+    rediscoverLastRequest();
+}
+
+void ProxyDiscoveryEngine::rediscoverLastRequest() {
+    std::string testUrl;
+    std::string pacUrl;
+    std::string guid;
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        testUrl = m_lastTestUrl;
+        pacUrl = m_lastPacUrl;
+        guid = m_lastGuid;
+    }
+    if (guid.empty()) {
+        return;
+    }
+    //rediscovered on the worker so it does not race the requests, observers hear of it only when the proxies changed
+    enqueueRequest({testUrl, pacUrl, guid, _make_token(std::nullopt),
+        [this, guid](ProxyRecords proxies, std::optional<ProxyRequestOutcome> aborted) {
+            if (aborted) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_snapshotMutex);
+                if (m_lastNotified && *m_lastNotified == proxies) {
+                    return;
+                }
+            }
+            notifyObservers(proxies, guid);
+        }});
 }
 
-std::list<ProxyRecord> ProxyDiscoveryEngine::getProxiesInternal() {
-    std::list<ProxyRecord> proxySettings;
+ProxyRecords ProxyDiscoveryEngine::readProxySettings() {
+    ScopedMetricTimer timer(PROXY_METRIC_ENVIRONMENT_SCAN);
+    ProxyRecords proxySettings;
     std::string desktop = m_commandExecutor->getEnvironmentVar("XDG_CURRENT_DESKTOP");
     try {
         if (desktop.find("GNOME") != std::string::npos) {
@@ -108,48 +400,56 @@ std::list<ProxyRecord> ProxyDiscoveryEngine::getProxiesInternal() {
             proxySettings = kdeProxy();
         }
 
+        //reads and parses one proxy variable of the environment
+        const auto envProxy = [this](const char *name) {
+            TraceSpan span("env var", name);
+            std::string value{ m_commandExecutor->getEnvironmentVar(name) };
+            std::optional<ProxyUrl> url = _valid_url(value);
+            return std::make_pair(std::move(value), std::move(url));
+        };
+
         bool httpSet = false;
-        const std::string httpProxy{ m_commandExecutor->getEnvironmentVar("http_proxy") };
-        if (_valid_url(httpProxy)) {
-            proxySettings.push_back({httpProxy, _get_port(httpProxy), ProxyTypes::HTTP});
+        const auto [httpProxy, httpUrl] = envProxy("http_proxy");
+        if (httpUrl) {
+            proxySettings.push_back({httpProxy, httpUrl->effectivePort(), ProxyTypes::HTTP});
             httpSet = true;
         }
 
         bool httpsSet = false;
-        const std::string httpsProxy{ m_commandExecutor->getEnvironmentVar("https_proxy") };
-        if (_valid_url(httpsProxy)) {
-            proxySettings.push_back({httpsProxy, _get_port(httpsProxy), ProxyTypes::HTTPS});
+        const auto [httpsProxy, httpsUrl] = envProxy("https_proxy");
+        if (httpsUrl) {
+            proxySettings.push_back({httpsProxy, httpsUrl->effectivePort(), ProxyTypes::HTTPS});
             httpsSet = true;
         }
 
         bool socksSet = false;
-        const std::string socksProxy{ m_commandExecutor->getEnvironmentVar("socks_proxy") };
-        if (_valid_url(socksProxy)) {
-            proxySettings.push_back({socksProxy, _get_port(socksProxy), ProxyTypes::SOCKS});
+        const auto [socksProxy, socksUrl] = envProxy("socks_proxy");
+        if (socksUrl) {
+            proxySettings.push_back({socksProxy, socksUrl->effectivePort(), ProxyTypes::SOCKS});
             socksSet = true;
         }
 
         bool ftpSet = false;
-        const std::string ftpProxy{ m_commandExecutor->getEnvironmentVar("ftp_proxy") };
-        if (_valid_url(ftpProxy)) {
-            proxySettings.push_back({ftpProxy, _get_port(ftpProxy), ProxyTypes::FTP});
+        const auto [ftpProxy, ftpUrl] = envProxy("ftp_proxy");
+        if (ftpUrl) {
+            proxySettings.push_back({ftpProxy, ftpUrl->effectivePort(), ProxyTypes::FTP});
             ftpSet = true;
         }
 
         if (!httpSet || !httpsSet || !socksSet || !ftpSet) {
-            const std::string allProxy{ m_commandExecutor->getEnvironmentVar("all_proxy") };
-            if (_valid_url(allProxy)) {
+            const auto [allProxy, url] = envProxy("all_proxy");
+            if (url) {
                 if (!httpSet) {
-                    proxySettings.push_back({allProxy, _get_port(allProxy), ProxyTypes::HTTP});
+                    proxySettings.push_back({allProxy, url->effectivePort(), ProxyTypes::HTTP});
                 }
                 if (!httpsSet) {
-                    proxySettings.push_back({allProxy, _get_port(allProxy), ProxyTypes::HTTPS});
+                    proxySettings.push_back({allProxy, url->effectivePort(), ProxyTypes::HTTPS});
                 }  
                 if (!socksSet) {
-                    proxySettings.push_back({allProxy, _get_port(allProxy), ProxyTypes::SOCKS});
+                    proxySettings.push_back({allProxy, url->effectivePort(), ProxyTypes::SOCKS});
                 }
                 if (!ftpSet) {
-                    proxySettings.push_back({allProxy, _get_port(allProxy), ProxyTypes::FTP});
+                    proxySettings.push_back({allProxy, url->effectivePort(), ProxyTypes::FTP});
                 }
             }
         }
@@ -160,62 +460,270 @@ std::list<ProxyRecord> ProxyDiscoveryEngine::getProxiesInternal() {
     return proxySettings;
 }
 
-std::list<ProxyRecord> ProxyDiscoveryEngine::getProxies(const std::string& testUrl, const std::string &) {
-    std::list<ProxyRecord> proxySettings = getProxiesInternal();
-    proxySettings.remove_if([this, &testUrl](const ProxyRecord &proxy) { return !m_proxyVerifier->verifyProxy(testUrl, proxy); });
+std::optional<ProxyLatency> ProxyDiscoveryEngine::proxyLatency(const ProxyRecord& proxy) {
+    return m_proxyVerifier->latency(proxy);
+}
+
+std::list<ProxyRecord> ProxyDiscoveryEngine::getProxies(const std::string& testUrl, const std::string &pacUrl) {
+    const ProxyRecords proxies = getProxyRecords(testUrl, pacUrl);
+    return std::list<ProxyRecord>(proxies.begin(), proxies.end());
+}
+
+ProxyRecords ProxyDiscoveryEngine::getProxyRecords(const std::string& testUrl, const std::string &pacUrl) {
+    ScopedMetricTimer timer(PROXY_METRIC_REQUEST, "kind", "sync");
+    TraceSpan span("getProxies", testUrl);
+    ProxyRecords proxySettings = getProxiesInternal();
+    expandPacProxies(testUrl, pacUrl, proxySettings);
+    removeUnverifiedProxies(testUrl, proxySettings);
+    rankProxies(proxySettings);
     return proxySettings;
 }
 
+void ProxyDiscoveryEngine::expandPacProxies(const std::string &testUrl, const std::string &pacUrl, ProxyRecords &proxies) {
+    const auto isPac = [](const ProxyRecord &proxy) { return proxy.proxyType == ProxyTypes::autoConfigurationURL; };
+    if (pacUrl.empty() && std::none_of(proxies.begin(), proxies.end(), isPac)) {
+        return;
+    }
 
-std::list<ProxyRecord> ProxyDiscoveryEngine::gnomeProxy() {
+    //each autoconfiguration record is replaced in place by the proxies its script returns
+    ProxyRecords expanded;
+    if (!pacUrl.empty()) {
+        PROXY_LOG_DEBUG("Pac url is provided for the proxy discovery: %s", pacUrl.c_str());
+        expanded = findPacProxies(testUrl, pacUrl);
+    }
+    for (auto &proxy : proxies) {
+        if (!isPac(proxy)) {
+            expanded.push_back(std::move(proxy));
+            continue;
+        }
+        ProxyRecords pacProxies = findPacProxies(testUrl, proxy.url);
+        expanded.append(std::make_move_iterator(pacProxies.begin()), std::make_move_iterator(pacProxies.end()));
+    }
+    proxies = std::move(expanded);
+}
 
-    std::list<ProxyRecord> records;
-    const std::string gsettingsCmd{ "/usr/bin/gsettings" };
-    std::vector<std::string> modeCmd{gsettingsCmd, "get", "org.gnome.system.proxy", "mode"};
+ProxyRecords ProxyDiscoveryEngine::findPacProxies(const std::string &testUrl, const std::string &scriptUrl) {
+    if (!m_pacEngine) {
+        PROXY_LOG_WARNING("Skipping proxy auto configuration url %s, no PAC script runtime was built in", scriptUrl.c_str());
+        return {};
+    }
+    if (scriptUrl.empty()) {
+        //an empty script url asks for web proxy auto discovery
+        PROXY_LOG_WARNING("Web proxy auto discovery not supported");
+        return {};
+    }
 
-    try {
-        CommandOutput modeOutput = m_commandExecutor->ExecuteCommandCaptureOutput(gsettingsCmd, modeCmd);
-        if (0 != modeOutput.exitCode_) {
-            PROXY_LOG_ERROR("Error obtaining gnome proxy mode");
-            return records;
+    const auto script = loadPacScript(scriptUrl);
+    //the script of a request stopped while it loaded is not evaluated, the result of an interrupted one is dropped
+    const CancellationToken *token = CancellationToken::current();
+    if (!script || (token && token->stopRequested())) {
+        return {};
+    }
+    ProxyRecords proxies = m_pacEngine->findProxies(*script, testUrl);
+    if (token && token->stopRequested()) {
+        return {};
+    }
+    return proxies;
+}
+
+std::optional<std::string> ProxyDiscoveryEngine::loadPacScript(const std::string &scriptUrl) {
+    const std::string filePrefix{ "file://" };
+    std::string path;
+    if (scriptUrl.rfind(filePrefix, 0) == 0) {
+        path = scriptUrl.substr(filePrefix.size());
+    } else if (!scriptUrl.empty() && scriptUrl.front() == '/') {
+        path = scriptUrl;
+    } else if (scriptUrl.rfind("http://", 0) == 0 || scriptUrl.rfind("https://", 0) == 0) {
+        if (!m_pacFetcher) {
+            PROXY_LOG_WARNING("Downloading PAC scripts not supported, ignoring %s", scriptUrl.c_str());
+            return std::nullopt;
         }
+        return m_pacFetcher->fetchScript(scriptUrl);
+    } else {
+        PROXY_LOG_WARNING("Unsupported PAC script url %s", scriptUrl.c_str());
+        return std::nullopt;
+    }
 
-        _trim_gsettings_output(modeOutput.output_);
-    
-        if (modeOutput.output_ == "none") {
-            PROXY_LOG_INFO("Proxy disabled in gnome settings");
-            return records;
-        } else if (modeOutput.output_ == "auto") {
-            //pac not supported (yet?)
-            PROXY_LOG_WARNING("Proxy auto configuration not supported");
-            return records;
-        } else if (modeOutput.output_ == "manual") {
-            auto httpProxy = parseGnomeProxy("http");
-            if (httpProxy.proxyType != ProxyTypes::None){
-                records.push_back(std::move(httpProxy));
-            }
-            auto httpsProxy = parseGnomeProxy("https");
-            if (httpsProxy.proxyType != ProxyTypes::None){
-                records.push_back(std::move(httpsProxy));
-            }
-            auto ftpProxy = parseGnomeProxy("ftp");
-            if (ftpProxy.proxyType != ProxyTypes::None){
-                records.push_back(std::move(ftpProxy));
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        PROXY_LOG_ERROR("Could not read PAC script %s", path.c_str());
+        return std::nullopt;
+    }
+    std::ostringstream script;
+    script << file.rdbuf();
+    return script.str();
+}
+
+void ProxyDiscoveryEngine::removeUnverifiedProxies(const std::string &testUrl, ProxyRecords &proxies) {
+    if (proxies.empty()) {
+        return;
+    }
+
+    //records sharing an endpoint (e.g. all_proxy expanded per protocol) are verified once
+    std::vector<ProxyRecord> endpoints;
+    std::vector<size_t> endpointOfProxy;
+    std::unordered_map<std::string, size_t> endpointIndexes;
+    endpointOfProxy.reserve(proxies.size());
+    for (const auto &proxy : proxies) {
+        const auto inserted = endpointIndexes.emplace(_endpoint_key(proxy), endpoints.size());
+        if (inserted.second) {
+            endpoints.push_back(proxy);
+        }
+        endpointOfProxy.push_back(inserted.first->second);
+    }
+
+    if (endpoints.size() < proxies.size()) {
+        PROXY_LOG_DEBUG("Verifying %zu unique endpoints for %zu proxies", endpoints.size(), proxies.size());
+    }
+    std::vector<bool> verified;
+    if (!m_healthMonitor) {
+        verified = m_proxyVerifier->verifyProxies(testUrl, endpoints);
+    } else {
+        //endpoints the monitor vouches for or has given up on are not verified again
+        std::vector<std::optional<bool>> health;
+        std::vector<ProxyRecord> unknown;
+        health.reserve(endpoints.size());
+        for (const auto &endpoint : endpoints) {
+            health.push_back(m_healthMonitor->health(testUrl, endpoint));
+            if (!health.back()) {
+                unknown.push_back(endpoint);
             }
-            auto socksProxy = parseGnomeProxy("socks");
-            if (socksProxy.proxyType != ProxyTypes::None){
-                records.push_back(std::move(socksProxy));
+        }
+        const std::vector<bool> checked = unknown.empty() ? std::vector<bool>{} : m_proxyVerifier->verifyProxies(testUrl, unknown);
+        std::vector<std::optional<bool>> results(endpoints.size());
+        size_t next = 0;
+        for (size_t i = 0; i < endpoints.size(); ++i) {
+            if (health[i]) {
+                verified.push_back(*health[i]);
+            } else {
+                results[i] = next < checked.size() && checked[next];
+                verified.push_back(*results[i]);
+                ++next;
             }
+        }
+        m_healthMonitor->track(testUrl, endpoints, results);
+    }
+
+    auto endpoint = endpointOfProxy.begin();
+    for (auto it = proxies.begin(); it != proxies.end(); ++endpoint) {
+        if (*endpoint < verified.size() && verified[*endpoint]) {
+            ++it;
         } else {
-            PROXY_LOG_WARNING("Unrecognized proxy mode");
+            it = proxies.erase(it);
+        }
+    }
+}
+
+void ProxyDiscoveryEngine::rankProxies(ProxyRecords &proxies) {
+    if (!m_options.rankByLatency || proxies.size() < 2) {
+        return;
+    }
+
+    std::vector<std::pair<std::optional<std::chrono::microseconds>, size_t>> scores;
+    scores.reserve(proxies.size());
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        const auto latency = m_proxyVerifier->latency(proxies[i]);
+        scores.emplace_back(latency ? std::optional<std::chrono::microseconds>(latency->score) : std::nullopt, i);
+    }
+    //unmeasured proxies go last, ties keep the discovery order
+    std::stable_sort(scores.begin(), scores.end(), [](const auto &lhs, const auto &rhs) {
+        if (lhs.first && rhs.first) {
+            return *lhs.first < *rhs.first;
+        }
+        return lhs.first.has_value() && !rhs.first.has_value();
+    });
+
+    ProxyRecords ranked;
+    ranked.reserve(proxies.size());
+    for (const auto &score : scores) {
+        ranked.push_back(std::move(proxies[score.second]));
+    }
+    proxies = std::move(ranked);
+}
+
+ProxyRecords ProxyDiscoveryEngine::gnomeProxy() {
+
+    ProxyRecords records;
+    if (m_options.readDconfDatabase) {
+        const std::string databasePath = dconfDatabasePath();
+        if (auto settings = readDconfProxySettings(databasePath)) {
+            PROXY_LOG_DEBUG("Using gnome proxy settings from dconf database %s", databasePath.c_str());
+            return gnomeProxyRecords(*settings);
         }
+        PROXY_LOG_DEBUG("dconf database %s not usable, falling back to gsettings", databasePath.c_str());
+    }
+
+    const std::string gsettingsCmd{ "/usr/bin/gsettings" };
+    //one process lists the whole schema tree, including the http/https/ftp/socks child schemas
+    std::vector<std::string> listCmd{gsettingsCmd, "list-recursively", "org.gnome.system.proxy"};
+
+    try {
+        CommandOutput listOutput = m_commandExecutor->ExecuteCommandCaptureOutput(gsettingsCmd, listCmd);
+        if (0 != listOutput.exitCode_) {
+            PROXY_LOG_ERROR("Error obtaining gnome proxy settings");
+            return records;
+        }
+
+        records = gnomeProxyRecords(parseGsettingsListing(listOutput.output_));
     } catch (const std::exception &e) {
         PROXY_LOG_ERROR("Command executor threw exception %s", e.what());
     }
     return records;
 }
 
-ProxyRecord ProxyDiscoveryEngine::parseGnomeProxy(const std::string& protocol) {
+std::string ProxyDiscoveryEngine::configHomePath() {
+    std::string configHome = m_commandExecutor->getEnvironmentVar("XDG_CONFIG_HOME");
+    if (configHome.empty()) {
+        configHome = m_commandExecutor->getEnvironmentVar("HOME") + "/.config";
+    }
+    return configHome;
+}
+
+std::string ProxyDiscoveryEngine::dconfDatabasePath() {
+    if (!m_options.dconfDatabasePath.empty()) {
+        return m_options.dconfDatabasePath;
+    }
+    return configHomePath() + "/dconf/user";
+}
+
+std::string ProxyDiscoveryEngine::kioslavercPath() {
+    if (!m_options.kioslavercPath.empty()) {
+        return m_options.kioslavercPath;
+    }
+    return configHomePath() + "/kioslaverc";
+}
+
+ProxyRecords ProxyDiscoveryEngine::gnomeProxyRecords(const GnomeProxySettings& settings) {
+    ProxyRecords records;
+    if (settings.mode == "none") {
+        PROXY_LOG_INFO("Proxy disabled in gnome settings");
+    } else if (settings.mode == "auto") {
+        //expanded with the test url once the settings are read
+        records.push_back({settings.autoconfigUrl, 0, ProxyTypes::autoConfigurationURL});
+    } else if (settings.mode == "manual") {
+        auto httpProxy = parseGnomeProxy(settings.http, "http");
+        if (httpProxy.proxyType != ProxyTypes::None){
+            records.push_back(std::move(httpProxy));
+        }
+        auto httpsProxy = parseGnomeProxy(settings.https, "https");
+        if (httpsProxy.proxyType != ProxyTypes::None){
+            records.push_back(std::move(httpsProxy));
+        }
+        auto ftpProxy = parseGnomeProxy(settings.ftp, "ftp");
+        if (ftpProxy.proxyType != ProxyTypes::None){
+            records.push_back(std::move(ftpProxy));
+        }
+        auto socksProxy = parseGnomeProxy(settings.socks, "socks");
+        if (socksProxy.proxyType != ProxyTypes::None){
+            records.push_back(std::move(socksProxy));
+        }
+    } else {
+        PROXY_LOG_WARNING("Unrecognized proxy mode");
+    }
+    return records;
+}
+
+ProxyRecord ProxyDiscoveryEngine::parseGnomeProxy(const GnomeProxyServer& server, const std::string& protocol) {
     ProxyTypes proxyType;
     std::string urlPrefix{ protocol };
     uint32_t defaultPort{ 0 };
@@ -238,32 +746,12 @@ ProxyRecord ProxyDiscoveryEngine::parseGnomeProxy(const std::string& protocol) {
         return { "", 0, ProxyTypes::None };
     }
 
-    const std::string gsettingsCmd{ "/usr/bin/gsettings" };
-    const std::string gnomeSystemProxySchema{ "org.gnome.system.proxy" };
-
-    std::vector<std::string> hostCmd{gsettingsCmd, "get", gnomeSystemProxySchema + "." + protocol, "host"};
-    std::vector<std::string> portCmd{gsettingsCmd, "get", gnomeSystemProxySchema + "." + protocol, "port"};
-    CommandOutput hostOutput = m_commandExecutor->ExecuteCommandCaptureOutput(hostCmd[0], hostCmd);
-    CommandOutput portOutput = m_commandExecutor->ExecuteCommandCaptureOutput(portCmd[0], portCmd);
-    if (0 != hostOutput.exitCode_) {
-        PROXY_LOG_ERROR("Error obtaining gnome %s proxy host", protocol);
-    }
-    if (0 != portOutput.exitCode_) {
-        PROXY_LOG_ERROR("Error obtaining gnome %s proxy port", protocol);
+    if (server.host.empty()) {
+        return { "", 0, ProxyTypes::None };
     }
-    _trim_gsettings_output(hostOutput.output_);
-    _trim_gsettings_output(portOutput.output_);
 
-
-    std::string url = _construct_url(hostOutput.output_, portOutput.output_, urlPrefix);
-    uint32_t port = 0;
-    if(portOutput.output_ != "") {
-        try {
-            port = (uint32_t)std::stoi(portOutput.output_);
-        } catch (const std::exception& e) {
-            PROXY_LOG_WARNING("Port could not be parsed");
-        }
-    }
+    std::string url = _construct_url(server.host, std::to_string(server.port), urlPrefix);
+    uint32_t port = server.port;
     if (port == 0) {
         port = defaultPort;
     } 
@@ -274,9 +762,89 @@ ProxyRecord ProxyDiscoveryEngine::parseGnomeProxy(const std::string& protocol) {
     return { "", 0, ProxyTypes::None };
 }
 
-std::list<ProxyRecord> ProxyDiscoveryEngine::kdeProxy() {
-    PROXY_LOG_WARNING("KDE Proxy settings not supported");
-    return std::list<ProxyRecord>{};
+ProxyRecords ProxyDiscoveryEngine::kdeProxy() {
+    ProxyRecords records;
+    const std::string configPath = kioslavercPath();
+    const auto settings = readKioslaverc(configPath);
+    if (!settings) {
+        PROXY_LOG_INFO("No KDE proxy settings found in %s", configPath.c_str());
+        return records;
+    }
+
+    const std::pair<const std::string*, ProxyTypes> proxies[] = {
+        { &settings->httpProxy, ProxyTypes::HTTP },
+        { &settings->httpsProxy, ProxyTypes::HTTPS },
+        { &settings->ftpProxy, ProxyTypes::FTP },
+        { &settings->socksProxy, ProxyTypes::SOCKS },
+    };
+
+    switch (settings->proxyType) {
+    case KdeProxyType::None:
+        PROXY_LOG_INFO("Proxy disabled in KDE settings");
+        break;
+    case KdeProxyType::Manual:
+        for (const auto& proxy : proxies) {
+            auto record = parseKdeProxy(*proxy.first, proxy.second);
+            if (record.proxyType != ProxyTypes::None) {
+                records.push_back(std::move(record));
+            }
+        }
+        break;
+    case KdeProxyType::ConfigScript:
+        records.push_back({settings->configScriptUrl, 0, ProxyTypes::autoConfigurationURL});
+        break;
+    case KdeProxyType::AutoDetect:
+        records.push_back({"", 0, ProxyTypes::autoConfigurationURL});
+        break;
+    case KdeProxyType::Environment:
+        for (const auto& proxy : proxies) {
+            const std::string& variable{ *proxy.first };
+            //the lower case variables are read for every desktop anyway
+            if (variable.empty() || variable == "http_proxy" || variable == "https_proxy" ||
+                variable == "ftp_proxy" || variable == "socks_proxy" || variable == "all_proxy") {
+                continue;
+            }
+            auto record = parseKdeProxy(m_commandExecutor->getEnvironmentVar(*proxy.first), proxy.second);
+            if (record.proxyType != ProxyTypes::None) {
+                records.push_back(std::move(record));
+            }
+        }
+        break;
+    }
+    return records;
+}
+
+//KDE stores proxies as "http://host:port" or, in older versions, "http://host port"
+ProxyRecord ProxyDiscoveryEngine::parseKdeProxy(const std::string& value, ProxyTypes proxyType) {
+    if (value.empty()) {
+        return { "", 0, ProxyTypes::None };
+    }
+
+    std::string url{ value };
+    const size_t space = url.find(' ');
+    if (space != std::string::npos) {
+        const size_t portStart = url.find_first_not_of(' ', space);
+        const std::string port = (portStart == std::string::npos) ? "" : url.substr(portStart);
+        url.erase(space);
+        if (!port.empty() && port != "0") {
+            url += ":" + port;
+        }
+    }
+
+    if (url.find("://") == std::string::npos) {
+        url = (proxyType == ProxyTypes::SOCKS ? "socks5://" : "http://") + url;
+    } else if (url.rfind("socks://", 0) == 0) {
+        url.replace(0, 5, "socks5");
+    }
+    if (!url.empty() && url.back() == '/') {
+        url.pop_back();
+    }
+
+    if (const auto parsed = _valid_url(url)) {
+        return { url, parsed->effectivePort(), proxyType };
+    }
+    PROXY_LOG_WARNING("Invalid KDE proxy setting %s", value.c_str());
+    return { "", 0, ProxyTypes::None };
 }
 
 } //proxy
\ No newline at end of file
@@ -8,42 +8,169 @@
 #include "IProxyDiscoveryEngine.h"
 #include "IProxyCommandExec.hpp"
 #include "IProxyVerifier.hpp"
+#include "IPacFetcher.hpp"
+#include "GnomeProxySettings.hpp"
+#include "PacEngine.hpp"
+#include "ProxyDiscoveryOptions.hpp"
 
+#include <condition_variable>
 #include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace proxy
 {
 
+class CancellationToken;
+class ObserverRegistry;
+class SettingsWatcher;
+class ProxyHealthMonitor;
+
 /**
  * @brief A class that performs available proxy settings discovery.
  */
 class ProxyDiscoveryEngine: public IProxyDiscoveryEngine {
 public:
     ~ProxyDiscoveryEngine();
-    explicit ProxyDiscoveryEngine(std::shared_ptr<IProxyCommandExec> commandExecutor, std::shared_ptr<IProxyVerifier> proxyVerifier);
+    /**
+     * @param pacEngine evaluates PAC scripts, proxy auto configuration is skipped when null
+     * @param pacFetcher downloads http and https PAC scripts, only file urls are read when null
+     * @param healthCheckVerifier checks proxies in the background when options.healthCheckInterval is set,
+     *        proxyVerifier when null
+     */
+    explicit ProxyDiscoveryEngine(std::shared_ptr<IProxyCommandExec> commandExecutor, std::shared_ptr<IProxyVerifier> proxyVerifier,
+                                  ProxyDiscoveryOptions options = {}, std::shared_ptr<PacEngine> pacEngine = nullptr,
+                                  std::shared_ptr<IPacFetcher> pacFetcher = nullptr,
+                                  std::shared_ptr<IProxyVerifier> healthCheckVerifier = nullptr);
     ProxyDiscoveryEngine(const ProxyDiscoveryEngine&) = delete;
     ProxyDiscoveryEngine(ProxyDiscoveryEngine&&) = delete;
     ProxyDiscoveryEngine& operator = (const ProxyDiscoveryEngine&) = delete;
     ProxyDiscoveryEngine& operator = (ProxyDiscoveryEngine&&) = delete;
     
     void addObserver(IProxyObserver& pObserver) override;
+    void removeObserver(IProxyObserver& pObserver) override;
     void requestProxiesAsync(const std::string& testUrl, const std::string &pacUrl, const std::string& guid) override;
+    void requestProxiesAsync(const std::string& testUrl, const std::string &pacUrl, const std::string& guid,
+                             std::chrono::milliseconds timeout) override;
+    /**
+     * @brief Queues the request like the observed ones, the callback runs on the discovery worker
+     */
+    void requestProxiesAsync(const std::string& testUrl, const std::string &pacUrl, const std::string& guid,
+                             std::optional<std::chrono::milliseconds> timeout, ProxyRequestCallback callback) override;
+    /**
+     * @brief Drops the queued requests made with guid and interrupts the running one, terminating its subprocesses
+     *        and aborting its transfers. Its PAC scripts are not evaluated any more, a running evaluation is only
+     *        interrupted with Duktape built with DUK_USE_EXEC_TIMEOUT_CHECK, see DuktapePacRuntime.
+     */
+    void cancel(const std::string& guid) override;
     std::list<ProxyRecord> getProxies(const std::string& testUrl, const std::string &pacUrl) override;
+    ProxyRecords getProxyRecords(const std::string& testUrl, const std::string &pacUrl) override;
+    std::optional<ProxyLatency> proxyLatency(const ProxyRecord& proxy) override;
+    /**
+     * @brief Waits until every queued asynchronous request has been discovered and its observers notified
+     */
     void waitPrevOpCompleted() override;
     
 private:
-    std::list<ProxyRecord> getProxiesInternal();
-    void notifyObservers(const std::list<ProxyRecord>& proxies, const std::string& guid);
-    std::list<ProxyRecord> gnomeProxy();
-    std::list<ProxyRecord> kdeProxy();
-    ProxyRecord parseGnomeProxy(const std::string& protocol);
+    struct PendingRequest
+    {
+        std::string testUrl;
+        std::string pacUrl;
+        std::string guid;
+        std::shared_ptr<CancellationToken> token;
+        ProxyRequestCallback complete;
+        std::chrono::steady_clock::time_point queuedAt = std::chrono::steady_clock::now();
+    };
+
+    /**
+     * @brief Queues a request answered through the observers
+     */
+    void requestObservedProxies(const std::string& testUrl, const std::string &pacUrl, const std::string& guid,
+                                std::optional<std::chrono::milliseconds> timeout);
+    void enqueueRequest(PendingRequest request);
+    /**
+     * @brief Runs queued asynchronous requests one at a time until the engine is destroyed
+     */
+    void workerLoop();
+    void discover(const PendingRequest &request);
+    /**
+     * @brief Returns the proxies configured on the system, from the snapshot when settings are watched
+     */
+    ProxyRecords getProxiesInternal();
+    ProxyRecords readProxySettings();
+    std::vector<std::string> watchedSettingsFiles();
+    /**
+     * @brief Drops the snapshot, so the settings are read again, and rediscovers the last asynchronous request
+     */
+    void onSettingsChanged();
+    /**
+     * @brief Queues a rediscovery of the last asynchronous request, after the settings changed or a background
+     *        check opened or closed a circuit. The observers are notified under that request's guid when the
+     *        proxies differ from the ones last notified.
+     */
+    void rediscoverLastRequest();
+    /**
+     * @brief Verifies all proxies as one batch and drops the ones that failed, keeping the original order.
+     *        Each unique endpoint (scheme, host, port) is verified once and its result applies to every record sharing it.
+     *        With health checks on, endpoints with a known health are not verified again.
+     */
+    void removeUnverifiedProxies(const std::string &testUrl, ProxyRecords &proxies);
+
+    /**
+     * @brief Orders proxies by their verification latency when options.rankByLatency is set
+     */
+    void rankProxies(ProxyRecords &proxies);
+    /**
+     * @brief Replaces every autoConfigurationURL record with the proxies its PAC script returns for the test url.
+     *        The proxies of pacUrl, when given, come first.
+     */
+    void expandPacProxies(const std::string &testUrl, const std::string &pacUrl, ProxyRecords &proxies);
+    ProxyRecords findPacProxies(const std::string &testUrl, const std::string &scriptUrl);
+    std::optional<std::string> loadPacScript(const std::string &scriptUrl);
+    void notifyObservers(const ProxyRecords& proxies, const std::string& guid);
+    void notifyAborted(const std::string& guid, ProxyRequestOutcome outcome);
+    ProxyRecords gnomeProxy();
+    std::string configHomePath();
+    std::string dconfDatabasePath();
+    std::string kioslavercPath();
+    ProxyRecords gnomeProxyRecords(const GnomeProxySettings& settings);
+    ProxyRecords kdeProxy();
+    ProxyRecord parseKdeProxy(const std::string& value, ProxyTypes proxyType);
+    ProxyRecord parseGnomeProxy(const GnomeProxyServer& server, const std::string& protocol);
 
     std::shared_ptr<IProxyCommandExec> m_commandExecutor;
     std::shared_ptr<IProxyVerifier> m_proxyVerifier;
-    std::deque<IProxyObserver*> m_observers;
-    std::shared_ptr<std::thread> m_thread;
+    ProxyDiscoveryOptions m_options;
+    std::shared_ptr<PacEngine> m_pacEngine;
+    std::shared_ptr<IPacFetcher> m_pacFetcher;
+    //shared with notifications handed to the notification executor
+    std::shared_ptr<ObserverRegistry> m_observers;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueChanged;
+    std::deque<PendingRequest> m_pendingRequests;
+    //requests that ended without running, their observers still get an answer
+    std::vector<std::pair<ProxyRequestCallback, ProxyRequestOutcome>> m_abortedRequests;
+    bool m_requestRunning = false;
+    std::shared_ptr<CancellationToken> m_runningToken;
+    std::string m_runningGuid;
+    bool m_stopWorker = false;
+    std::thread m_worker;
+
+    std::mutex m_snapshotMutex;
+    std::optional<ProxyRecords> m_settingsSnapshot;
+    //bumped by every settings change, a read started before it does not become the snapshot
+    uint64_t m_settingsGeneration = 0;
+    std::string m_lastTestUrl;
+    std::string m_lastPacUrl;
+    std::string m_lastGuid;
+    std::unique_ptr<SettingsWatcher> m_settingsWatcher;
+    std::optional<ProxyRecords> m_lastNotified;
+    std::unique_ptr<ProxyHealthMonitor> m_healthMonitor;
 };
 
 } //proxy namespace
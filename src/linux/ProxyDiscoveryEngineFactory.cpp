@@ -5,16 +5,62 @@
  */
 
 #include "ProxyDiscoveryEngine.hpp"
+#include "CachingCommandExec.hpp"
+#include "CachingProxyVerifier.hpp"
+#include "PacFetcher.hpp"
 #include "ProxyCommandExec.hpp"
 #include "ProxyVerifier.hpp"
+#ifdef PROXY_DISCOVERY_HAVE_DUKTAPE
+#include "DuktapePacRuntime.hpp"
+#endif
 
 namespace proxy
 {
 
 std::shared_ptr<IProxyDiscoveryEngine> createProxyEngine()
 {
+    return createProxyEngine(ProxyDiscoveryOptions{});
+}
+
+std::shared_ptr<IProxyDiscoveryEngine> createProxyEngine(const ProxyDiscoveryOptions& options)
+{
+    std::shared_ptr<IProxyCommandExec> commandExecutor = std::make_shared<ProxyCommandExec>(options.commandTimeout);
+    if (options.commandCacheTtl.count() > 0) {
+        commandExecutor = std::make_shared<CachingCommandExec>(commandExecutor, options.commandCacheTtl);
+    }
+    std::shared_ptr<PacEngine> pacEngine;
+    std::shared_ptr<IPacFetcher> pacFetcher;
+#ifdef PROXY_DISCOVERY_HAVE_DUKTAPE
+    pacEngine = std::make_shared<PacEngine>(std::make_shared<DuktapePacRuntime>());
+    std::string pacCacheDirectory = options.pacCacheDirectory;
+    if (pacCacheDirectory.empty()) {
+        std::string cacheHome = commandExecutor->getEnvironmentVar("XDG_CACHE_HOME");
+        if (cacheHome.empty()) {
+            const std::string home = commandExecutor->getEnvironmentVar("HOME");
+            cacheHome = home.empty() ? "" : home + "/.cache";
+        }
+        pacCacheDirectory = cacheHome.empty() ? "" : cacheHome + "/ProxyDiscovery/pac";
+    }
+    pacFetcher = std::make_shared<PacFetcher>(pacCacheDirectory);
+#endif
+    std::shared_ptr<DnsCache> dnsCache;
+    if (options.dnsCacheTtl.count() > 0) {
+        dnsCache = std::make_shared<DnsCache>(options.dnsCacheTtl, options.dnsNegativeCacheTtl);
+    }
+    const auto proxyVerifier = std::make_shared<ProxyVerifier>(std::chrono::seconds(30), dnsCache, options.verificationDepth);
+    std::shared_ptr<IProxyVerifier> requestVerifier = proxyVerifier;
+    if (options.verificationCacheTtl.count() > 0 || options.verificationNegativeCacheTtl.count() > 0) {
+        requestVerifier = std::make_shared<CachingProxyVerifier>(proxyVerifier, options.verificationCacheTtl,
+                                                                 options.verificationNegativeCacheTtl);
+    }
+    //background checks must reach the proxies, a cached result would hide a change of health
     return std::make_shared<ProxyDiscoveryEngine>(
-        std::make_shared<ProxyCommandExec>(), std::make_shared<ProxyVerifier>());
+        commandExecutor,
+        requestVerifier,
+        options,
+        pacEngine,
+        pacFetcher,
+        proxyVerifier);
 }
 
 } //proxy namespace
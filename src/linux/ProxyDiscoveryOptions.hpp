@@ -0,0 +1,143 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IProxyDiscoveryEngine.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace proxy
+{
+
+/**
+ * @brief How far a proxy is exercised before it counts as working
+ */
+enum class VerificationDepth
+{
+    //a TCP connection to the proxy
+    Connect,
+    //the CONNECT or SOCKS handshake that opens a tunnel to the test url's host through the proxy
+    Handshake,
+    //a HEAD request for the test url through the proxy
+    Head,
+    //a GET request for the test url through the proxy, the body is downloaded and discarded
+    Get
+};
+
+/**
+ * @brief Optional behaviour of the Linux proxy discovery engine. The defaults match createProxyEngine().
+ */
+struct ProxyDiscoveryOptions
+{
+    /**
+     * @brief Read GNOME proxy settings straight from the user's dconf database instead of running gsettings.
+     *        gsettings is still used when the database is missing or does not set the proxy mode.
+     */
+    bool readDconfDatabase = false;
+
+    /**
+     * @brief The dconf database to read, empty for $XDG_CONFIG_HOME/dconf/user
+     */
+    std::string dconfDatabasePath;
+
+    /**
+     * @brief The KDE settings file to read, empty for $XDG_CONFIG_HOME/kioslaverc
+     */
+    std::string kioslavercPath;
+
+    /**
+     * @brief Keep the discovered settings in memory and watch the settings files for changes instead of
+     *        re-reading them on every request. When the discovered proxies change, observers are notified
+     *        with the test url and guid of the last requestProxiesAsync call.
+     */
+    bool watchSettings = false;
+
+    /**
+     * @brief Where downloaded PAC scripts are cached between runs, empty for $XDG_CACHE_HOME/ProxyDiscovery/pac
+     */
+    std::string pacCacheDirectory;
+
+    /**
+     * @brief How long a helper command such as gsettings may run before it is terminated
+     */
+    std::chrono::milliseconds commandTimeout = std::chrono::seconds(5);
+
+    /**
+     * @brief How long the output of a helper command is reused by later requests, zero to run it every time
+     */
+    std::chrono::milliseconds commandCacheTtl = std::chrono::milliseconds(0);
+
+    /**
+     * @brief How long a passed proxy verification is reused by later requests, zero to verify every time
+     */
+    std::chrono::milliseconds verificationCacheTtl = std::chrono::milliseconds(0);
+
+    /**
+     * @brief How long a failed proxy verification is reused by later requests, zero to verify every time
+     */
+    std::chrono::milliseconds verificationNegativeCacheTtl = std::chrono::milliseconds(0);
+
+    /**
+     * @brief How many asynchronous requests may wait for the discovery worker. When the queue is full the oldest
+     *        waiting request is dropped and its observers are told it was cancelled.
+     */
+    size_t maxPendingRequests = 16;
+
+    /**
+     * @brief How long the addresses of a proxy host are reused. Each host is looked up once ahead of its
+     *        verifications, which then connect to the addresses found. Zero to let curl look up every verification.
+     */
+    std::chrono::milliseconds dnsCacheTtl = std::chrono::seconds(60);
+
+    /**
+     * @brief How long a proxy host that does not resolve fails verification without being looked up again
+     */
+    std::chrono::milliseconds dnsNegativeCacheTtl = std::chrono::seconds(5);
+
+    /**
+     * @brief How far each proxy is exercised. The cheaper depths save the bandwidth and time of downloading the
+     *        test url but vouch for less of the path through the proxy.
+     */
+    VerificationDepth verificationDepth = VerificationDepth::Get;
+
+    /**
+     * @brief Order the verified proxies by their smoothed verification latency, fastest first, instead of the
+     *        order they were discovered in. Proxies not measured yet keep their order after the measured ones.
+     */
+    bool rankByLatency = false;
+
+    /**
+     * @brief How often the proxies of recent discoveries are checked in the background, zero for no background
+     *        checks. Discoveries reuse the result of the last check instead of verifying a proxy again, and
+     *        observers are notified with the last request's guid when a proxy stops or starts working.
+     */
+    std::chrono::milliseconds healthCheckInterval = std::chrono::milliseconds(0);
+
+    /**
+     * @brief The longest delay between the background checks of a failing proxy, which doubles after each failure
+     */
+    std::chrono::milliseconds healthCheckMaxBackoff = std::chrono::minutes(5);
+
+    /**
+     * @brief How many background checks in a row a proxy may fail before discoveries skip it without verifying it
+     */
+    unsigned circuitBreakerThreshold = 3;
+
+    /**
+     * @brief Runs observer notifications, for example on a thread pool, so a slow observer does not hold up the
+     *        discovery worker. Empty to notify on the worker. waitPrevOpCompleted does not wait for notifications
+     *        already handed to the executor.
+     */
+    std::function<void(std::function<void()>)> notificationExecutor;
+};
+
+std::shared_ptr<IProxyDiscoveryEngine> PROXY_DISCOVERY_MODULE_API createProxyEngine(const ProxyDiscoveryOptions& options);
+
+} //proxy
@@ -0,0 +1,202 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "ProxyHealthMonitor.hpp"
+#include "ProxyLoggerDef.hpp"
+
+#include <algorithm>
+
+namespace proxy {
+
+//the test urls whose endpoints are checked, the least recently discovered is dropped first
+static constexpr size_t s_maxTargets = 16;
+
+ProxyHealthMonitor::ProxyHealthMonitor(std::shared_ptr<IProxyVerifier> verifier, std::chrono::milliseconds interval,
+                                       std::chrono::milliseconds maxBackoff, unsigned failureThreshold,
+                                       std::function<void()> onHealthChanged) :
+    m_verifier(std::move(verifier)),
+    m_interval(std::max(interval, std::chrono::milliseconds(1))),
+    m_maxBackoff(std::max(maxBackoff, m_interval)),
+    m_failureThreshold(std::max(failureThreshold, 1u)),
+    m_onHealthChanged(std::move(onHealthChanged)),
+    m_random(std::random_device{}())
+{
+}
+
+ProxyHealthMonitor::~ProxyHealthMonitor()
+{
+    stop();
+}
+
+void ProxyHealthMonitor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_stopToken.cancel();
+    m_changed.notify_all();
+    if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) {
+        m_thread.join();
+    }
+}
+
+void ProxyHealthMonitor::track(const std::string &testUrl, const std::vector<ProxyRecord> &endpoints,
+                               const std::vector<std::optional<bool>> &verified)
+{
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Target target;
+    target.lastTracked = ++m_trackCount;
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        const Endpoint *known = find(testUrl, endpoints[i]);
+        Endpoint endpoint = known ? *known : Endpoint{ endpoints[i], 0, false, now + m_interval };
+        if (i < verified.size() && verified[i]) {
+            //the discovery already told the observers, only checks report changes
+            apply(endpoint, *verified[i], now);
+        }
+        target.endpoints.push_back(std::move(endpoint));
+    }
+
+    if (m_targets.count(testUrl) == 0 && m_targets.size() >= s_maxTargets) {
+        m_targets.erase(std::min_element(m_targets.begin(), m_targets.end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.second.lastTracked < rhs.second.lastTracked; }));
+    }
+    m_targets[testUrl] = std::move(target);
+
+    if (!m_stopping && !m_thread.joinable()) {
+        m_thread = std::thread(&ProxyHealthMonitor::run, this);
+    }
+    m_changed.notify_all();
+}
+
+std::optional<bool> ProxyHealthMonitor::health(const std::string &testUrl, const ProxyRecord &endpoint) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Endpoint *known = find(testUrl, endpoint);
+    if (!known) {
+        return std::nullopt;
+    }
+    if (known->open) {
+        return false;
+    }
+    if (known->failures == 0) {
+        return true;
+    }
+    return std::nullopt;
+}
+
+size_t ProxyHealthMonitor::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t endpoints = 0;
+    for (const auto &target : m_targets) {
+        endpoints += target.second.endpoints.size();
+    }
+    return endpoints;
+}
+
+bool ProxyHealthMonitor::apply(Endpoint &endpoint, bool passed, Clock::time_point now)
+{
+    const bool wasOpen = endpoint.open;
+    if (passed) {
+        endpoint.failures = 0;
+        endpoint.open = false;
+        endpoint.nextCheck = now + m_interval;
+        return wasOpen;
+    }
+
+    ++endpoint.failures;
+    endpoint.open = endpoint.failures >= m_failureThreshold;
+    //interval * 2^(failures - 1), capped, then somewhere in its upper half so failing checks do not line up
+    const unsigned doublings = std::min(endpoint.failures - 1, 20u);
+    const auto backoff = std::min<std::chrono::milliseconds>(m_interval * (1LL << doublings), m_maxBackoff);
+    const double jitter = std::uniform_real_distribution<double>(0.5, 1.0)(m_random);
+    endpoint.nextCheck = now + std::chrono::duration_cast<std::chrono::milliseconds>(backoff * jitter);
+    return endpoint.open != wasOpen;
+}
+
+ProxyHealthMonitor::Endpoint *ProxyHealthMonitor::find(const std::string &testUrl, const ProxyRecord &proxy)
+{
+    return const_cast<Endpoint*>(static_cast<const ProxyHealthMonitor*>(this)->find(testUrl, proxy));
+}
+
+const ProxyHealthMonitor::Endpoint *ProxyHealthMonitor::find(const std::string &testUrl, const ProxyRecord &proxy) const
+{
+    const auto target = m_targets.find(testUrl);
+    if (target == m_targets.end()) {
+        return nullptr;
+    }
+    const auto it = std::find_if(target->second.endpoints.begin(), target->second.endpoints.end(),
+        [&proxy](const Endpoint &endpoint) { return endpoint.proxy.url == proxy.url && endpoint.proxy.port == proxy.port; });
+    return it == target->second.endpoints.end() ? nullptr : &*it;
+}
+
+void ProxyHealthMonitor::run()
+{
+    CancellationToken::Scope scope(&m_stopToken);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping) {
+        auto nextCheck = Clock::time_point::max();
+        for (const auto &target : m_targets) {
+            for (const auto &endpoint : target.second.endpoints) {
+                nextCheck = std::min(nextCheck, endpoint.nextCheck);
+            }
+        }
+        if (Clock::now() < nextCheck) {
+            //woken early when endpoints are tracked or the monitor stops
+            if (nextCheck == Clock::time_point::max()) {
+                m_changed.wait(lock);
+            } else {
+                m_changed.wait_until(lock, nextCheck);
+            }
+            continue;
+        }
+
+        std::vector<std::pair<std::string, std::vector<ProxyRecord>>> due;
+        const auto now = Clock::now();
+        for (const auto &target : m_targets) {
+            std::vector<ProxyRecord> proxies;
+            for (const auto &endpoint : target.second.endpoints) {
+                if (endpoint.nextCheck <= now) {
+                    proxies.push_back(endpoint.proxy);
+                }
+            }
+            if (!proxies.empty()) {
+                due.emplace_back(target.first, std::move(proxies));
+            }
+        }
+
+        bool healthChanged = false;
+        for (const auto &check : due) {
+            lock.unlock();
+            const std::vector<bool> passed = m_verifier->verifyProxies(check.first, check.second);
+            lock.lock();
+            if (m_stopping) {
+                return;
+            }
+            const auto checked = Clock::now();
+            for (size_t i = 0; i < check.second.size(); ++i) {
+                //the endpoint may have gone with a newer discovery while it was checked
+                if (Endpoint *endpoint = find(check.first, check.second[i])) {
+                    if (apply(*endpoint, i < passed.size() && passed[i], checked)) {
+                        PROXY_LOG_INFO("Proxy %s %s", endpoint->proxy.url.c_str(),
+                                       endpoint->open ? "keeps failing, skipping it" : "recovered");
+                        healthChanged = true;
+                    }
+                }
+            }
+        }
+
+        if (healthChanged && m_onHealthChanged) {
+            lock.unlock();
+            m_onHealthChanged();
+            lock.lock();
+        }
+    }
+}
+
+} //proxy
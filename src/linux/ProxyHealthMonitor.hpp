@@ -0,0 +1,116 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include "IProxyVerifier.hpp"
+#include "CancellationToken.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief Keeps checking the proxy endpoints of recent discoveries in the background.
+ *        A working endpoint is checked every interval. A failing one is retried with an exponential backoff
+ *        with jitter, and after a number of failures in a row its circuit opens: discoveries skip it without
+ *        verifying it until a check passes again.
+ */
+class ProxyHealthMonitor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param verifier checks the endpoints, it should not answer from a cache
+     * @param interval how often a working endpoint is checked, and the first retry delay of a failing one
+     * @param maxBackoff the longest delay between the checks of a failing endpoint
+     * @param failureThreshold how many failures in a row open the circuit of an endpoint
+     * @param onHealthChanged called on the checking thread when a check opened or closed a circuit
+     */
+    ProxyHealthMonitor(std::shared_ptr<IProxyVerifier> verifier, std::chrono::milliseconds interval,
+                       std::chrono::milliseconds maxBackoff, unsigned failureThreshold,
+                       std::function<void()> onHealthChanged);
+    ~ProxyHealthMonitor();
+    ProxyHealthMonitor(const ProxyHealthMonitor&) = delete;
+    ProxyHealthMonitor& operator = (const ProxyHealthMonitor&) = delete;
+
+    /**
+     * @brief Stops checking and waits for a running check to end, onHealthChanged is not called any more.
+     *        Endpoints can still be tracked and their health queried.
+     */
+    void stop();
+
+    /**
+     * @brief Checks the endpoints of a discovery for testUrl from now on, instead of those of the previous one
+     * @param testUrl the url the endpoints are checked against
+     * @param endpoints the endpoints of the discovery
+     * @param verified for each endpoint, the result of its verification by the discovery or none when the
+     *        discovery did not verify it
+     */
+    void track(const std::string &testUrl, const std::vector<ProxyRecord> &endpoints,
+               const std::vector<std::optional<bool>> &verified);
+
+    /**
+     * @return True when the last check of the endpoint passed, false while its circuit is open, none when the
+     *         endpoint is not checked or is failing with its circuit still closed
+     */
+    std::optional<bool> health(const std::string &testUrl, const ProxyRecord &endpoint) const;
+
+    /**
+     * @return The number of endpoints checked
+     */
+    size_t size() const;
+
+private:
+    struct Endpoint
+    {
+        ProxyRecord proxy;
+        unsigned failures = 0;
+        bool open = false;
+        Clock::time_point nextCheck;
+    };
+
+    struct Target
+    {
+        std::vector<Endpoint> endpoints;
+        uint64_t lastTracked = 0;
+    };
+
+    //called with m_mutex held, true when the circuit of the endpoint opened or closed
+    bool apply(Endpoint &endpoint, bool passed, Clock::time_point now);
+    Endpoint *find(const std::string &testUrl, const ProxyRecord &proxy);
+    const Endpoint *find(const std::string &testUrl, const ProxyRecord &proxy) const;
+    void run();
+
+    std::shared_ptr<IProxyVerifier> m_verifier;
+    std::chrono::milliseconds m_interval;
+    std::chrono::milliseconds m_maxBackoff;
+    unsigned m_failureThreshold;
+    std::function<void()> m_onHealthChanged;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::unordered_map<std::string, Target> m_targets;
+    uint64_t m_trackCount = 0;
+    std::mt19937 m_random;
+    bool m_stopping = false;
+    //aborts a running check when the monitor stops
+    CancellationToken m_stopToken;
+    std::thread m_thread;
+};
+
+} //proxy
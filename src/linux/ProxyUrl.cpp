@@ -0,0 +1,132 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "ProxyUrl.hpp"
+
+namespace proxy {
+
+namespace {
+
+bool _is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool _is_hex_digit(char c)
+{
+    return _is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool _is_host_char(char c)
+{
+    return _is_digit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '.' || c == '_' || c == '-';
+}
+
+//user and password, both non-empty, as "user:password"
+bool _valid_userinfo(std::string_view userinfo)
+{
+    const size_t colon = userinfo.find(':');
+    if (colon == 0 || colon == std::string_view::npos || colon + 1 == userinfo.size()) {
+        return false;
+    }
+    for (char c : userinfo.substr(colon + 1)) {
+        if (c == ':' || c == '/') {
+            return false;
+        }
+    }
+    return true;
+}
+
+} //namespace
+
+uint32_t ProxyUrl::effectivePort() const
+{
+    if (hasPort) {
+        return port;
+    }
+    if (scheme == "http") {
+        return 80;
+    } else if (scheme == "https") {
+        return 443;
+    } else if (scheme == "socks5" || scheme == "socks4") {
+        return 1080;
+    }
+    return 0;
+}
+
+std::optional<ProxyUrl> parseProxyUrl(std::string_view url)
+{
+    ProxyUrl result;
+
+    const size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string_view::npos) {
+        return std::nullopt;
+    }
+    result.scheme = url.substr(0, schemeEnd);
+    if (result.scheme != "http" && result.scheme != "https" && result.scheme != "socks5" &&
+        result.scheme != "socks4" && result.scheme != "ftp") {
+        return std::nullopt;
+    }
+
+    std::string_view rest = url.substr(schemeEnd + 3);
+    const size_t at = rest.rfind('@');
+    if (at != std::string_view::npos) {
+        result.userinfo = rest.substr(0, at);
+        if (!_valid_userinfo(result.userinfo)) {
+            return std::nullopt;
+        }
+        rest.remove_prefix(at + 1);
+    }
+
+    size_t pos = 0;
+    if (!rest.empty() && rest[0] == '[') {
+        const size_t close = rest.find(']');
+        if (close == std::string_view::npos || close == 1) {
+            return std::nullopt;
+        }
+        result.host = rest.substr(1, close - 1);
+        bool hasColon = false;
+        for (char c : result.host) {
+            if (!_is_hex_digit(c) && c != ':' && c != '.') {
+                return std::nullopt;
+            }
+            hasColon = hasColon || c == ':';
+        }
+        if (!hasColon) {
+            return std::nullopt;
+        }
+        result.bracketedHost = true;
+        pos = close + 1;
+    } else {
+        while (pos < rest.size() && _is_host_char(rest[pos])) {
+            ++pos;
+        }
+        if (pos == 0) {
+            return std::nullopt;
+        }
+        result.host = rest.substr(0, pos);
+    }
+
+    if (pos == rest.size()) {
+        return result;
+    }
+    if (rest[pos] != ':' || pos + 1 == rest.size()) {
+        return std::nullopt;
+    }
+    for (++pos; pos < rest.size(); ++pos) {
+        if (!_is_digit(rest[pos])) {
+            return std::nullopt;
+        }
+        result.port = result.port * 10 + static_cast<uint32_t>(rest[pos] - '0');
+        if (result.port > 65535) {
+            return std::nullopt;
+        }
+    }
+    result.hasPort = true;
+    return result;
+}
+
+} //proxy
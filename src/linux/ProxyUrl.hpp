@@ -0,0 +1,46 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace proxy {
+
+/**
+ * @brief The parts of a proxy url, viewing into the parsed string
+ */
+struct ProxyUrl
+{
+    std::string_view scheme;
+    std::string_view userinfo;
+    //without the brackets of an IPv6 address
+    std::string_view host;
+    uint32_t port = 0;
+    bool hasPort = false;
+    bool bracketedHost = false;
+
+    /**
+     * @return The port of the url, or the default port of its scheme: 80 for http, 443 for https,
+     *         1080 for socks4 and socks5 and 0 for ftp
+     */
+    uint32_t effectivePort() const;
+};
+
+/**
+ * @brief Validates and splits a proxy url of the form scheme://[userinfo@]host[:port] in a single pass
+ *        without allocating.
+ *        The scheme is one of http, https, socks4, socks5 and ftp. The host is a name or IPv4 address made
+ *        of letters, digits, '.', '_' and '-', or an IPv6 address in brackets. The port is 0-65535.
+ *        A path, query or fragment makes the url invalid.
+ * @param url the url to parse, the result views into it
+ * @return The parts of the url, or nullopt if it is not a valid proxy url
+ */
+std::optional<ProxyUrl> parseProxyUrl(std::string_view url);
+
+} //proxy
@@ -6,70 +6,386 @@
 
 #include "ProxyVerifier.hpp"
 #include "ProxyLoggerDef.hpp"
-#include <unistd.h>
+#include "ProxyMetricsDef.hpp"
+#include "ProxyTracer.hpp"
+#include "ProxyUrl.hpp"
+#include "CancellationToken.hpp"
 #include <curl/curl.h>
+#include <algorithm>
+
+#include <arpa/inet.h>
 
 namespace proxy {
 
 static curl_proxytype _detectProxyType(const std::string& proxyUrl) {
-    if (proxyUrl.rfind("https://", 0) == 0) {
-        return CURLPROXY_HTTPS;
-    } else if (proxyUrl.rfind("http://", 0) == 0) {
+    const auto url = parseProxyUrl(proxyUrl);
+    if (!url) {
         return CURLPROXY_HTTP;
-    } else if (proxyUrl.rfind("socks5://", 0) == 0) {
+    }
+    if (url->scheme == "https") {
+        return CURLPROXY_HTTPS;
+    } else if (url->scheme == "socks5") {
         return CURLPROXY_SOCKS5;
-    } else if (proxyUrl.rfind("socks4://", 0) == 0) {
+    } else if (url->scheme == "socks4") {
         return CURLPROXY_SOCKS4;
     }
     return CURLPROXY_HTTP;
 }
 
-static std::string getCABundlePath() {
-    // different paths for rhel/debian
-    const std::string paths[] {
-        "/etc/pki/tls/certs/ca-bundle.crt",
-        "/etc/ssl/certs/ca-certificates.crt"
-    };
-    for (const std::string path : paths) {
-        if(access(path.c_str(), R_OK) == 0) {
-            return path;
+//the port curl connects to, CURLOPT_PROXYPORT only applies when the url has none
+static uint32_t _proxy_port(const ProxyUrl &url, const ProxyRecord &proxyRecord)
+{
+    if (url.hasPort) {
+        return url.port;
+    }
+    return proxyRecord.port != 0 ? proxyRecord.port : url.effectivePort();
+}
+
+static size_t _discard_body(char *, size_t size, size_t nmemb, void *)
+{
+    return size * nmemb;
+}
+
+static void _setup_handle(CURL *curl, const std::string &testUrl, const ProxyRecord &proxyRecord, const std::string &caPath,
+                          VerificationDepth depth)
+{
+    if (depth == VerificationDepth::Connect) {
+        //connects straight to the proxy endpoint and stops there, nothing goes through the proxy
+        const auto url = parseProxyUrl(proxyRecord.url);
+        std::string endpoint = proxyRecord.url;
+        if (url) {
+            const std::string host{ url->host };
+            endpoint = "http://" + (url->bracketedHost ? "[" + host + "]" : host) + ":" + std::to_string(_proxy_port(*url, proxyRecord));
         }
+        curl_easy_setopt(curl, CURLOPT_URL, endpoint.c_str());
+        //an empty proxy keeps curl from picking one up from the environment
+        curl_easy_setopt(curl, CURLOPT_PROXY, "");
+        curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
+        return;
+    }
+
+    curl_easy_setopt(curl, CURLOPT_PROXY, proxyRecord.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_PROXYTYPE, _detectProxyType(proxyRecord.url));
+    curl_easy_setopt(curl, CURLOPT_PROXYPORT, proxyRecord.port);
+    curl_easy_setopt(curl, CURLOPT_URL, testUrl.c_str());
+    if (!caPath.empty()) {
+        curl_easy_setopt(curl, CURLOPT_CAINFO, caPath.c_str());
+    }
+    //curl writes the body to stdout unless told otherwise
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &_discard_body);
+    if (depth == VerificationDepth::Handshake) {
+        //HTTP proxies are asked for a CONNECT tunnel, SOCKS proxies handshake while connecting
+        curl_easy_setopt(curl, CURLOPT_HTTPPROXYTUNNEL, 1L);
+        curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
+    } else if (depth == VerificationDepth::Head) {
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    }
+}
+
+namespace {
+
+struct CurlSlistDeleter
+{
+    void operator()(curl_slist *list) const
+    {
+        curl_slist_free_all(list);
+    }
+};
+
+//the resolved addresses of a proxy host, for CURLOPT_RESOLVE
+struct HostPin
+{
+    std::unique_ptr<curl_slist, CurlSlistDeleter> resolve;
+    bool unresolvable = false;
+};
+
+} //namespace
+
+//resolves the proxy host names through the cache, proxies given by address are left to curl
+static std::vector<HostPin> _pin_hosts(DnsCache *dnsCache, const std::vector<ProxyRecord> &proxies,
+                                       std::chrono::steady_clock::time_point deadline)
+{
+    std::vector<HostPin> pins(proxies.size());
+    if (!dnsCache) {
+        return pins;
+    }
+
+    std::vector<size_t> pinned;
+    std::vector<std::string> hosts;
+    std::vector<uint32_t> ports;
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        const auto url = parseProxyUrl(proxies[i].url);
+        if (!url || url->bracketedHost) {
+            continue;
+        }
+        const std::string host{ url->host };
+        in_addr address{};
+        const uint32_t port = _proxy_port(*url, proxies[i]);
+        if (port == 0 || inet_pton(AF_INET, host.c_str(), &address) == 1) {
+            continue;
+        }
+        pinned.push_back(i);
+        hosts.push_back(host);
+        ports.push_back(port);
+    }
+    if (hosts.empty()) {
+        return pins;
+    }
+
+    const auto resolved = dnsCache->resolve(hosts, deadline);
+    for (size_t j = 0; j < pinned.size(); ++j) {
+        if (!resolved[j]) {
+            continue;
+        }
+        HostPin &pin = pins[pinned[j]];
+        if (resolved[j]->empty()) {
+            pin.unresolvable = true;
+            continue;
+        }
+#if LIBCURL_VERSION_NUM >= 0x074b00
+        //'+' lets the entry expire from the shared DNS cache like a lookup of curl's own
+        std::string entry = "+" + hosts[j] + ":" + std::to_string(ports[j]) + ":";
+#else
+        std::string entry = hosts[j] + ":" + std::to_string(ports[j]) + ":";
+#endif
+        for (size_t k = 0; k < resolved[j]->size(); ++k) {
+            entry += (k == 0 ? "" : ",") + (*resolved[j])[k];
+        }
+        pin.resolve.reset(curl_slist_append(nullptr, entry.c_str()));
+    }
+    return pins;
+}
+
+//the timings of a finished transfer, curl reports them from its start
+static ProxyLatency _measure(CURL *curl)
+{
+    curl_off_t connect = 0;
+    curl_off_t handshake = 0;
+    curl_off_t firstByte = 0;
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    //covers the CONNECT request of a tunnel and the TLS session of an https proxy
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &handshake);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &firstByte);
+
+    ProxyLatency latency;
+    latency.connect = std::chrono::microseconds(connect);
+    latency.handshake = std::chrono::microseconds(handshake > connect ? handshake : 0);
+    latency.firstByte = std::chrono::microseconds(firstByte);
+    latency.score = std::max({ latency.connect, latency.handshake, latency.firstByte });
+    return latency;
+}
+
+static void _log_result(const ProxyRecord &proxyRecord, CURLcode res)
+{
+    if(res != CURLE_OK) {
+        PROXY_LOG_ERROR("proxy %s failed verification: %s\n", proxyRecord.url.c_str(), curl_easy_strerror(res));
+    } else {
+        PROXY_LOG_INFO("proxy %s passed verification\n", proxyRecord.url.c_str());
+    }
+}
+
+//counts a verification by its curl result code, or by why it has none, and times its transfer when there was one
+static void _count_result(CURL *curl, CURLcode res)
+{
+    GetProxyMetrics().incrementCounter(PROXY_METRIC_VERIFICATIONS, { { "code", std::to_string(res) } });
+    curl_off_t total = 0;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+    GetProxyMetrics().observeDuration(PROXY_METRIC_VERIFICATION, {}, std::chrono::microseconds(total));
+}
+
+static void _count_result(std::string_view noTransfer)
+{
+    GetProxyMetrics().incrementCounter(PROXY_METRIC_VERIFICATIONS, { { "code", noTransfer } });
+}
+
+//records a finished transfer and its dns, connect and tls phases as a track of their own, transfers overlap
+static void _trace_transfer(CURL *curl, const ProxyRecord &proxyRecord)
+{
+    if (!tracingEnabled()) {
+        return;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    curl_off_t total = 0;
+    curl_off_t nameLookup = 0;
+    curl_off_t connect = 0;
+    curl_off_t appConnect = 0;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &nameLookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appConnect);
+
+    const auto start = end - std::chrono::microseconds(total);
+    const auto at = [start](curl_off_t offset) { return start + std::chrono::microseconds(offset); };
+    const uint64_t id = nextTraceId();
+    recordTraceSpan("probe", proxyRecord.url, start, end, id);
+    recordTraceSpan("dns", proxyRecord.url, start, at(nameLookup), id);
+    if (connect > 0) {
+        recordTraceSpan("connect", proxyRecord.url, at(nameLookup), at(connect), id);
+    }
+    if (appConnect > connect) {
+        recordTraceSpan("tls", proxyRecord.url, at(connect), at(appConnect), id);
     }
-    return "";
 }
 
 bool ProxyVerifier::verifyProxy(const std::string &testUrl, const ProxyRecord &proxyRecord)
 {
-    CURL *curl;
     CURLcode res;
     bool ret = false;
-    /* get a curl handle */
-    curl = curl_easy_init();
+    const std::vector<HostPin> pins = _pin_hosts(m_dnsCache.get(), { proxyRecord },
+                                                 std::chrono::steady_clock::now() + m_verificationTimeout);
+    if (pins.front().unresolvable) {
+        PROXY_LOG_ERROR("proxy %s failed verification: its host does not resolve\n", proxyRecord.url.c_str());
+        _count_result("unresolvable");
+        return false;
+    }
+    /* get a pooled curl handle, it goes back to the pool on return */
+    CurlHandlePool::Handle curl = m_handlePool->acquire();
     if (curl) {
-        curl_easy_setopt(curl, CURLOPT_PROXY, proxyRecord.url.c_str());
-        curl_easy_setopt(curl, CURLOPT_PROXYTYPE, _detectProxyType(proxyRecord.url));
-        curl_easy_setopt(curl, CURLOPT_PROXYPORT, proxyRecord.port);
-        curl_easy_setopt(curl, CURLOPT_URL, testUrl.c_str());
-        std::string caPath = getCABundlePath();
-        if (!caPath.empty()) {
-            curl_easy_setopt(curl, CURLOPT_CAINFO, caPath.c_str());
+        _setup_handle(curl.get(), testUrl, proxyRecord, caBundlePath(), m_depth);
+        limitTransfer(curl.get(), m_verificationTimeout);
+        if (pins.front().resolve) {
+            curl_easy_setopt(curl.get(), CURLOPT_RESOLVE, pins.front().resolve.get());
         }
 
         /* Perform the request, res gets the return code */
-        res = curl_easy_perform(curl);
+        res = curl_easy_perform(curl.get());
         /* Check for errors */
-        if(res != CURLE_OK) {
-            PROXY_LOG_ERROR("proxy %s failed verification: %s\n", proxyRecord.url.c_str(), curl_easy_strerror(res));
-        } else {
-            PROXY_LOG_INFO("proxy %s passed verification\n", proxyRecord.url.c_str());
-            ret = true;
+        _log_result(proxyRecord, res);
+        _count_result(curl.get(), res);
+        _trace_transfer(curl.get(), proxyRecord);
+        ret = (res == CURLE_OK);
+        if (ret) {
+            m_latencies.record(proxyRecord, _measure(curl.get()));
         }
-    
-        /* always cleanup */
-        curl_easy_cleanup(curl);
     }
 
     return ret;
 }
 
+std::vector<bool> ProxyVerifier::verifyProxies(const std::string &testUrl, const std::vector<ProxyRecord> &proxies)
+{
+    std::vector<bool> results(proxies.size(), false);
+    if (proxies.empty()) {
+        return results;
+    }
+
+    CURLM *multi = curl_multi_init();
+    if (!multi) {
+        PROXY_LOG_ERROR("curl_multi_init failed, falling back to sequential verification");
+        return IProxyVerifier::verifyProxies(testUrl, proxies);
+    }
+
+    CancellationToken *token = CancellationToken::current();
+    auto deadline = std::chrono::steady_clock::now() + m_verificationTimeout;
+    size_t cancelHook = 0;
+    if (token) {
+        deadline = token->limitDeadline(deadline);
+        // wakes curl_multi_poll so a cancelled request stops waiting for its transfers
+        cancelHook = token->addHook([multi]() { curl_multi_wakeup(multi); });
+    }
+    const std::string caPath = caBundlePath();
+    // the pinned addresses must outlive the transfers using them
+    const std::vector<HostPin> pins = _pin_hosts(m_dnsCache.get(), proxies, deadline);
+    std::vector<CurlHandlePool::Handle> handles;
+    handles.reserve(proxies.size());
+    std::vector<bool> counted(proxies.size(), false);
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        if (pins[i].unresolvable) {
+            PROXY_LOG_ERROR("proxy %s failed verification: its host does not resolve\n", proxies[i].url.c_str());
+            _count_result("unresolvable");
+            counted[i] = true;
+            handles.push_back(CurlHandlePool::Handle{ nullptr, CurlHandlePool::HandleReleaser{ m_handlePool.get() } });
+            continue;
+        }
+        handles.push_back(m_handlePool->acquire());
+        CURL *curl = handles.back().get();
+        if (!curl) {
+            PROXY_LOG_ERROR("curl_easy_init failed for proxy %s", proxies[i].url.c_str());
+            continue;
+        }
+        _setup_handle(curl, testUrl, proxies[i], caPath, m_depth);
+        limitTransfer(curl, m_verificationTimeout);
+        if (pins[i].resolve) {
+            curl_easy_setopt(curl, CURLOPT_RESOLVE, pins[i].resolve.get());
+        }
+        curl_multi_add_handle(multi, curl);
+    }
+
+    int running = 0;
+    for (;;) {
+        CURLMcode mc = curl_multi_perform(multi, &running);
+        if (mc != CURLM_OK) {
+            PROXY_LOG_ERROR("curl_multi_perform failed: %s", curl_multi_strerror(mc));
+            break;
+        }
+
+        int queued = 0;
+        while (CURLMsg *msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            const auto it = std::find_if(handles.begin(), handles.end(),
+                [msg](const CurlHandlePool::Handle &handle) { return handle.get() == msg->easy_handle; });
+            if (it != handles.end()) {
+                const size_t idx = static_cast<size_t>(it - handles.begin());
+                _log_result(proxies[idx], msg->data.result);
+                _count_result(msg->easy_handle, msg->data.result);
+                _trace_transfer(msg->easy_handle, proxies[idx]);
+                counted[idx] = true;
+                results[idx] = (msg->data.result == CURLE_OK);
+                if (results[idx]) {
+                    m_latencies.record(proxies[idx], _measure(msg->easy_handle));
+                }
+            }
+        }
+
+        if (running == 0) {
+            break;
+        }
+
+        if (token && token->isCancelled()) {
+            PROXY_LOG_INFO("proxy verification cancelled with %d transfers still running", running);
+            break;
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            PROXY_LOG_WARNING("proxy verification timed out with %d transfers still running", running);
+            break;
+        }
+
+        mc = curl_multi_poll(multi, nullptr, 0, static_cast<int>(std::min<long long>(remaining.count(), 1000)), nullptr);
+        if (mc != CURLM_OK) {
+            PROXY_LOG_ERROR("curl_multi_poll failed: %s", curl_multi_strerror(mc));
+            break;
+        }
+    }
+
+    if (token) {
+        token->removeHook(cancelHook);
+    }
+    //cut short by the deadline or a cancellation, or never started
+    for (size_t i = 0; i < counted.size(); ++i) {
+        if (!counted[i]) {
+            _count_result("unfinished");
+        }
+    }
+
+    /* always cleanup, handles go back to the pool once detached from the multi handle */
+    for (const auto &curl : handles) {
+        if (curl) {
+            curl_multi_remove_handle(multi, curl.get());
+        }
+    }
+    handles.clear();
+    curl_multi_cleanup(multi);
+
+    return results;
+}
+
+std::optional<ProxyLatency> ProxyVerifier::latency(const ProxyRecord &proxyRecord)
+{
+    return m_latencies.latency(proxyRecord);
+}
+
 } //proxy
\ No newline at end of file
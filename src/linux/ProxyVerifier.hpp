@@ -7,19 +7,38 @@
 #pragma once
 
 #include "IProxyVerifier.hpp"
+#include "CurlHandlePool.hpp"
+#include "DnsCache.hpp"
+#include "ProxyDiscoveryOptions.hpp"
+#include "LatencyTracker.hpp"
 #include <curl/curl.h>
 
+#include <chrono>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace proxy {
 
 class ProxyVerifier : public IProxyVerifier
 {
 public:
-    ProxyVerifier() {
+    /**
+     * @param verificationTimeout upper bound for a single verification and for a whole batch
+     *        verified with verifyProxies
+     * @param dnsCache resolves proxy hosts before their transfers start, which then connect to the resolved
+     *        addresses and are not started for hosts that do not resolve. Null to let curl resolve each transfer.
+     * @param depth how far each proxy is exercised
+     */
+    explicit ProxyVerifier(std::chrono::milliseconds verificationTimeout = std::chrono::seconds(30),
+                           std::shared_ptr<DnsCache> dnsCache = nullptr,
+                           VerificationDepth depth = VerificationDepth::Get) :
+        m_verificationTimeout(verificationTimeout), m_dnsCache(std::move(dnsCache)), m_depth(depth) {
         curl_global_init(CURL_GLOBAL_DEFAULT);
+        m_handlePool = std::make_unique<CurlHandlePool>();
     }
     ~ProxyVerifier() {
+        m_handlePool.reset();
         curl_global_cleanup();
     }
     /**
@@ -29,6 +48,29 @@ public:
      * @return True of proxy server is valid, false if not
      */
     bool verifyProxy(const std::string &testUrl, const ProxyRecord &proxyRecord) override;
+
+    /**
+     * @brief Verifies all proxies concurrently on a single curl multi handle
+     * @param testUrl the url to perform a test connection to
+     * @param proxies the proxy servers to test
+     * @return Verification results in the same order as proxies. Proxies that did not complete
+     *         before the verification timeout, or before the discovery request was cancelled or
+     *         timed out, are reported as failed.
+     */
+    std::vector<bool> verifyProxies(const std::string &testUrl, const std::vector<ProxyRecord> &proxies) override;
+
+    /**
+     * @return The connect, handshake and first byte times of the proxy's passed verifications, each smoothed
+     *         with an exponentially weighted moving average
+     */
+    std::optional<ProxyLatency> latency(const ProxyRecord &proxyRecord) override;
+
+private:
+    std::chrono::milliseconds m_verificationTimeout;
+    std::shared_ptr<DnsCache> m_dnsCache;
+    VerificationDepth m_depth;
+    LatencyTracker m_latencies;
+    std::unique_ptr<CurlHandlePool> m_handlePool;
 };
 
-} //proxy
\ No newline at end of file
+} //proxy
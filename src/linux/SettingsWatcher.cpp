@@ -0,0 +1,137 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include "SettingsWatcher.hpp"
+#include "ProxyLoggerDef.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace proxy {
+
+namespace {
+
+const uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+} //namespace
+
+SettingsWatcher::SettingsWatcher(const std::vector<std::string> &files, ChangeCallback callback,
+                                 std::chrono::milliseconds debounce) :
+    m_callback(std::move(callback)),
+    m_debounce(debounce)
+{
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        PROXY_LOG_ERROR("inotify_init1 failed: %d", errno);
+        return;
+    }
+
+    for (const auto &file : files) {
+        const size_t separator = file.find_last_of('/');
+        if (separator == std::string::npos || separator + 1 == file.size()) {
+            PROXY_LOG_WARNING("Not watching %s, an absolute file path is required", file.c_str());
+            continue;
+        }
+        const std::string directory = separator == 0 ? "/" : file.substr(0, separator);
+        const int wd = inotify_add_watch(m_inotifyFd, directory.c_str(), kWatchMask);
+        if (wd < 0) {
+            PROXY_LOG_DEBUG("Not watching %s: %d", directory.c_str(), errno);
+            continue;
+        }
+        m_watchedNames[wd].push_back(file.substr(separator + 1));
+        PROXY_LOG_DEBUG("Watching %s for proxy settings changes", file.c_str());
+    }
+
+    if (m_watchedNames.empty() || pipe2(m_stopPipe, O_CLOEXEC) != 0) {
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+        return;
+    }
+    m_thread = std::thread(&SettingsWatcher::run, this);
+}
+
+SettingsWatcher::~SettingsWatcher()
+{
+    if (m_thread.joinable()) {
+        const char stop = 0;
+        (void)write(m_stopPipe[1], &stop, 1);
+        m_thread.join();
+    }
+    for (int fd : { m_inotifyFd, m_stopPipe[0], m_stopPipe[1] }) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool SettingsWatcher::isWatching() const
+{
+    return m_thread.joinable();
+}
+
+bool SettingsWatcher::drainEvents()
+{
+    bool changed = false;
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (ssize_t offset = 0; offset < length; ) {
+            const auto *event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            if (event->mask & IN_Q_OVERFLOW) {
+                changed = true;
+                continue;
+            }
+            const auto it = m_watchedNames.find(event->wd);
+            if (it != m_watchedNames.end() && event->len > 0 &&
+                std::find(it->second.begin(), it->second.end(), std::string(event->name)) != it->second.end()) {
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+void SettingsWatcher::run()
+{
+    bool pending = false;
+    for (;;) {
+        struct pollfd fds[2] = {
+            { m_inotifyFd, POLLIN, 0 },
+            { m_stopPipe[0], POLLIN, 0 }
+        };
+        //while a change is pending, wait only for the quiet period before reporting it
+        const int timeout = pending ? static_cast<int>(m_debounce.count()) : -1;
+        const int ready = poll(fds, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PROXY_LOG_ERROR("poll failed while watching settings: %d", errno);
+            return;
+        }
+        if (fds[1].revents) {
+            return;
+        }
+        if (ready == 0) {
+            pending = false;
+            m_callback();
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            pending = drainEvents() || pending;
+        }
+    }
+}
+
+} //proxy
@@ -0,0 +1,56 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief Watches a set of settings files with inotify and reports changes from a background thread.
+ *        The parent directories are watched, so files that are replaced by rename, created or deleted
+ *        are noticed as well. Bursts of events are coalesced into one callback.
+ */
+class SettingsWatcher
+{
+public:
+    using ChangeCallback = std::function<void()>;
+
+    /**
+     * @param files the files to watch, files in directories that do not exist are ignored
+     * @param callback called on the watcher thread after a watched file changed
+     * @param debounce quiet period after the last event before the callback is called
+     */
+    SettingsWatcher(const std::vector<std::string> &files, ChangeCallback callback,
+                    std::chrono::milliseconds debounce = std::chrono::milliseconds(200));
+    ~SettingsWatcher();
+    SettingsWatcher(const SettingsWatcher&) = delete;
+    SettingsWatcher& operator = (const SettingsWatcher&) = delete;
+
+    /**
+     * @return True if at least one file is being watched
+     */
+    bool isWatching() const;
+
+private:
+    void run();
+    bool drainEvents();
+
+    ChangeCallback m_callback;
+    std::chrono::milliseconds m_debounce;
+    int m_inotifyFd = -1;
+    int m_stopPipe[2] = { -1, -1 };
+    std::map<int, std::vector<std::string>> m_watchedNames;
+    std::thread m_thread;
+};
+
+} //proxy
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved.
+ */
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace proxy {
+
+/**
+ * @brief A single threaded HTTP/1.0 server on 127.0.0.1 for tests. Every connection carries one request,
+ *        answered by the handler and closed.
+ */
+class LocalHttpServer
+{
+public:
+   struct Request
+   {
+      std::string method;
+      std::string path;
+      //header names in lower case
+      std::map<std::string, std::string> headers;
+   };
+
+   struct Response
+   {
+      int status = 200;
+      std::map<std::string, std::string> headers;
+      std::string body;
+      std::chrono::milliseconds delay{ 0 };
+   };
+
+   using Handler = std::function<Response(const Request&)>;
+
+   explicit LocalHttpServer(Handler handler) : handler_(std::move(handler))
+   {
+      listenFd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      sockaddr_in address{};
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t length = sizeof(address);
+      bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+      listen(listenFd_, 16);
+      getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length);
+      port_ = ntohs(address.sin_port);
+      thread_ = std::thread([this]() { serve(); });
+   }
+
+   ~LocalHttpServer()
+   {
+      stop();
+   }
+
+   void stop()
+   {
+      if (thread_.joinable()) {
+         stopping_ = true;
+         thread_.join();
+         close(listenFd_);
+      }
+   }
+
+   std::string url(const std::string& path) const
+   {
+      return "http://127.0.0.1:" + std::to_string(port_) + path;
+   }
+
+   std::vector<Request> requests()
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return requests_;
+   }
+
+private:
+   void serve()
+   {
+      while (!stopping_) {
+         pollfd pfd{ listenFd_, POLLIN, 0 };
+         if (poll(&pfd, 1, 20) <= 0) {
+            continue;
+         }
+         const int fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+         if (fd < 0) {
+            continue;
+         }
+         handle(fd);
+         close(fd);
+      }
+   }
+
+   void handle(int fd)
+   {
+      std::string data;
+      char buffer[4096];
+      while (data.find("\r\n\r\n") == std::string::npos) {
+         const ssize_t n = read(fd, buffer, sizeof(buffer));
+         if (n <= 0) {
+            return;
+         }
+         data.append(buffer, static_cast<size_t>(n));
+      }
+
+      Request request;
+      size_t lineEnd = data.find("\r\n");
+      const std::string requestLine = data.substr(0, lineEnd);
+      request.method = requestLine.substr(0, requestLine.find(' '));
+      request.path = requestLine.substr(request.method.size() + 1, requestLine.rfind(' ') - request.method.size() - 1);
+      for (size_t start = lineEnd + 2; (lineEnd = data.find("\r\n", start)) != start; start = lineEnd + 2) {
+         const std::string line = data.substr(start, lineEnd - start);
+         const size_t colon = line.find(':');
+         std::string name = line.substr(0, colon);
+         for (auto& c : name) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+         }
+         request.headers[name] = line.substr(line.find_first_not_of(' ', colon + 1));
+      }
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         requests_.push_back(request);
+      }
+
+      const Response response = handler_(request);
+      std::this_thread::sleep_for(response.delay);
+      std::string reply = "HTTP/1.0 " + std::to_string(response.status) + " Status\r\n";
+      for (const auto& header : response.headers) {
+         reply += header.first + ": " + header.second + "\r\n";
+      }
+      reply += "Content-Length: " + std::to_string(response.body.size()) + "\r\n\r\n" + response.body;
+      send(fd, reply.data(), reply.size(), MSG_NOSIGNAL);
+   }
+
+   Handler handler_;
+   int listenFd_ = -1;
+   uint16_t port_ = 0;
+   std::atomic<bool> stopping_{ false };
+   std::thread thread_;
+   std::mutex mutex_;
+   std::vector<Request> requests_;
+};
+
+} //proxy
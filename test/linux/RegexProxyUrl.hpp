@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved.
+ */
+#pragma once
+
+#include <cstdint>
+#include <regex>
+#include <string>
+
+namespace proxy {
+namespace regex_reference {
+
+//the std::regex based url checks ProxyUrl replaced, kept to compare against
+
+inline bool isAuthenticatedUrl(const std::string& url) {
+    std::regex authenticatedUrlPattern{R"(^(https?|socks5|socks4|ftp)://[^:@]+:[^/:]+@[^/:]+(:\d+)?)"};
+    return std::regex_match(url, authenticatedUrlPattern);
+}
+
+inline bool validUrl(const std::string& url) {
+    std::regex urlPattern{R"(^(?:https?|socks5|socks4|ftp)://[a-zA-Z0-9._-]+(?:\:\d+)?$)"};
+    if (isAuthenticatedUrl(url)) {
+        return false;
+    }
+    return std::regex_match(url, urlPattern);
+}
+
+inline uint32_t getPort(const std::string& url) {
+    std::regex urlPattern{R"(^(?:https?|socks5|socks4|ftp)://[a-zA-Z0-9._-]+(?:\:\d+)$)"};
+    if (!std::regex_match(url, urlPattern)) {
+        if (url.rfind("https://", 0) == 0) {
+            return 443;
+        } else if (url.rfind("http://", 0) == 0) {
+            return 80;
+        } else if (url.rfind("socks5://", 0) == 0) {
+            return 1080;
+        } else if (url.rfind("socks4://", 0) == 0) {
+            return 1080;
+        }
+        return 0;
+    }
+    return static_cast<uint32_t>(std::stoi(url.substr(url.find_last_of(":") + 1)));
+}
+
+} //regex_reference
+} //proxy
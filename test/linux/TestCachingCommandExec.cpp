@@ -0,0 +1,136 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "MockCommandExec.hpp"
+#include "CachingCommandExec.hpp"
+
+#include <chrono>
+#include <thread>
+
+using testing::Invoke;
+using testing::Return;
+using testing::Throw;
+using testing::_;
+
+namespace {
+
+const std::string gsettings_cmd{ "/usr/bin/gsettings" };
+const std::vector<std::string> mode_cmd{ gsettings_cmd, "get", "org.gnome.system.proxy", "mode" };
+const std::vector<std::string> host_cmd{ gsettings_cmd, "get", "org.gnome.system.proxy.http", "host" };
+
+} //namespace
+
+class TestCachingCommandExec : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      commandExecutorPtr_ = std::make_shared<MockCommandExec>();
+   }
+
+   std::unique_ptr<CachingCommandExec> makeCache(std::chrono::milliseconds ttl, size_t maxEntries = 16)
+   {
+      return std::make_unique<CachingCommandExec>(commandExecutorPtr_, ttl, maxEntries);
+   }
+
+   std::shared_ptr<MockCommandExec> commandExecutorPtr_;
+};
+
+TEST_F(TestCachingCommandExec, outputIsCached)
+{
+   auto cache = makeCache(std::chrono::minutes(5));
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd)).WillOnce(Return(CommandOutput{ 0, "'manual'\n" }));
+
+   EXPECT_EQ(cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd).output_, "'manual'\n");
+   EXPECT_EQ(cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd).output_, "'manual'\n");
+}
+
+TEST_F(TestCachingCommandExec, keyIncludesArguments)
+{
+   auto cache = makeCache(std::chrono::minutes(5));
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd)).WillOnce(Return(CommandOutput{ 0, "'manual'\n" }));
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, host_cmd)).WillOnce(Return(CommandOutput{ 0, "'proxy.com'\n" }));
+
+   EXPECT_EQ(cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd).output_, "'manual'\n");
+   EXPECT_EQ(cache->ExecuteCommandCaptureOutput(gsettings_cmd, host_cmd).output_, "'proxy.com'\n");
+   EXPECT_EQ(cache->size(), 2);
+}
+
+TEST_F(TestCachingCommandExec, expiredOutputIsExecutedAgain)
+{
+   auto cache = makeCache(std::chrono::milliseconds(20));
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd)).Times(2).WillRepeatedly(Return(CommandOutput{ 0, "'none'\n" }));
+
+   cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd);
+   std::this_thread::sleep_for(std::chrono::milliseconds(40));
+   cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd);
+}
+
+TEST_F(TestCachingCommandExec, invalidateDropsOutput)
+{
+   auto cache = makeCache(std::chrono::minutes(5));
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd)).Times(2).WillRepeatedly(Return(CommandOutput{ 0, "'none'\n" }));
+
+   cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd);
+   cache->invalidate();
+   EXPECT_EQ(cache->size(), 0);
+   cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd);
+}
+
+TEST_F(TestCachingCommandExec, exceptionIsNotCached)
+{
+   auto cache = makeCache(std::chrono::minutes(5));
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd))
+      .WillOnce(Throw(std::runtime_error("timed out")))
+      .WillOnce(Return(CommandOutput{ 0, "'none'\n" }));
+
+   EXPECT_THROW(cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd), std::runtime_error);
+   EXPECT_EQ(cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd).output_, "'none'\n");
+}
+
+TEST_F(TestCachingCommandExec, sizeIsBounded)
+{
+   auto cache = makeCache(std::chrono::minutes(5), 1);
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, _)).WillRepeatedly(Return(CommandOutput{ 0, "" }));
+
+   cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd);
+   cache->ExecuteCommandCaptureOutput(gsettings_cmd, host_cmd);
+   EXPECT_EQ(cache->size(), 1);
+}
+
+TEST_F(TestCachingCommandExec, concurrentCallsShareOneExecution)
+{
+   auto cache = makeCache(std::chrono::minutes(5));
+   EXPECT_CALL(*commandExecutorPtr_, ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd))
+      .WillOnce(Invoke([](const std::string &, const std::vector<std::string> &) {
+         std::this_thread::sleep_for(std::chrono::milliseconds(100));
+         return CommandOutput{ 0, "'auto'\n" };
+      }));
+
+   std::vector<std::thread> threads;
+   std::vector<std::string> outputs(4);
+   for (size_t i = 0; i < outputs.size(); ++i) {
+      threads.emplace_back([&cache, &outputs, i]() {
+         outputs[i] = cache->ExecuteCommandCaptureOutput(gsettings_cmd, mode_cmd).output_;
+      });
+   }
+   for (auto &thread : threads) {
+      thread.join();
+   }
+   EXPECT_THAT(outputs, testing::Each(std::string("'auto'\n")));
+}
+
+TEST_F(TestCachingCommandExec, environmentIsReadThrough)
+{
+   auto cache = makeCache(std::chrono::minutes(5));
+   EXPECT_CALL(*commandExecutorPtr_, getEnvironmentVar("http_proxy")).Times(2).WillRepeatedly(Return("http://proxy.com"));
+
+   EXPECT_EQ(cache->getEnvironmentVar("http_proxy"), "http://proxy.com");
+   EXPECT_EQ(cache->getEnvironmentVar("http_proxy"), "http://proxy.com");
+}
@@ -0,0 +1,123 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "MockProxyVerifier.hpp"
+#include "CachingProxyVerifier.hpp"
+
+#include <chrono>
+#include <thread>
+
+using testing::Return;
+using testing::_;
+
+namespace proxy {
+
+namespace {
+
+const std::string test_url{ "test_url" };
+const std::string other_test_url{ "other_test_url" };
+const ProxyRecord http_proxy{ "http://httpproxy.com:8080", 8080, ProxyTypes::HTTP };
+const ProxyRecord https_proxy{ "https://httpsproxy.com:3333", 3333, ProxyTypes::HTTPS };
+const ProxyRecord socks_proxy{ "socks5://socksproxy.com:1080", 1080, ProxyTypes::SOCKS };
+
+} //namespace
+
+class TestCachingProxyVerifier : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      proxyVerifierPtr_ = std::make_shared<MockProxyVerifier>();
+   }
+
+   std::unique_ptr<CachingProxyVerifier> makeCache(std::chrono::milliseconds positiveTtl, std::chrono::milliseconds negativeTtl, size_t maxEntries = 16)
+   {
+      return std::make_unique<CachingProxyVerifier>(proxyVerifierPtr_, positiveTtl, negativeTtl, maxEntries);
+   }
+
+   std::shared_ptr<MockProxyVerifier> proxyVerifierPtr_;
+};
+
+TEST_F(TestCachingProxyVerifier, positiveResultIsCached)
+{
+   auto cache = makeCache(std::chrono::minutes(5), std::chrono::minutes(5));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, http_proxy)).WillOnce(Return(true));
+
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+}
+
+TEST_F(TestCachingProxyVerifier, negativeResultUsesItsOwnTtl)
+{
+   auto cache = makeCache(std::chrono::minutes(5), std::chrono::milliseconds(0));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, http_proxy)).Times(2).WillRepeatedly(Return(false));
+
+   EXPECT_FALSE(cache->verifyProxy(test_url, http_proxy));
+   EXPECT_FALSE(cache->verifyProxy(test_url, http_proxy));
+}
+
+TEST_F(TestCachingProxyVerifier, expiredResultIsVerifiedAgain)
+{
+   auto cache = makeCache(std::chrono::milliseconds(20), std::chrono::milliseconds(20));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, http_proxy)).Times(2).WillRepeatedly(Return(true));
+
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+   std::this_thread::sleep_for(std::chrono::milliseconds(40));
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+}
+
+TEST_F(TestCachingProxyVerifier, keyIncludesTestUrlAndProxyType)
+{
+   auto cache = makeCache(std::chrono::minutes(5), std::chrono::minutes(5));
+   const ProxyRecord sameUrlOtherType{ http_proxy.url, http_proxy.port, ProxyTypes::FTP };
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, http_proxy)).WillOnce(Return(true));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(other_test_url, http_proxy)).WillOnce(Return(false));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, sameUrlOtherType)).WillOnce(Return(false));
+
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+   EXPECT_FALSE(cache->verifyProxy(other_test_url, http_proxy));
+   EXPECT_FALSE(cache->verifyProxy(test_url, sameUrlOtherType));
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+}
+
+TEST_F(TestCachingProxyVerifier, invalidateDropsResults)
+{
+   auto cache = makeCache(std::chrono::minutes(5), std::chrono::minutes(5));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, http_proxy)).Times(2).WillRepeatedly(Return(true));
+
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+   cache->invalidate();
+   EXPECT_EQ(cache->size(), 0);
+   EXPECT_TRUE(cache->verifyProxy(test_url, http_proxy));
+}
+
+TEST_F(TestCachingProxyVerifier, sizeIsBounded)
+{
+   auto cache = makeCache(std::chrono::minutes(5), std::chrono::minutes(5), 2);
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, _)).WillRepeatedly(Return(true));
+
+   cache->verifyProxy(test_url, http_proxy);
+   cache->verifyProxy(test_url, https_proxy);
+   cache->verifyProxy(test_url, socks_proxy);
+   EXPECT_EQ(cache->size(), 2);
+}
+
+TEST_F(TestCachingProxyVerifier, batchForwardsOnlyMisses)
+{
+   auto cache = makeCache(std::chrono::minutes(5), std::chrono::minutes(5));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, https_proxy)).WillOnce(Return(false));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, http_proxy)).WillOnce(Return(true));
+   EXPECT_CALL(*proxyVerifierPtr_, verifyProxy(test_url, socks_proxy)).WillOnce(Return(true));
+
+   EXPECT_FALSE(cache->verifyProxy(test_url, https_proxy));
+   EXPECT_THAT(cache->verifyProxies(test_url, { http_proxy, https_proxy, socks_proxy }), testing::ElementsAre(true, false, true));
+   EXPECT_THAT(cache->verifyProxies(test_url, { socks_proxy, http_proxy, https_proxy }), testing::ElementsAre(true, true, false));
+}
+
+} //proxy
@@ -0,0 +1,79 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+
+#include "CancellationToken.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace proxy {
+
+TEST(TestCancellationToken, cancelRunsHooksOnce)
+{
+   CancellationToken token;
+   int calls = 0;
+   token.addHook([&calls]() { ++calls; });
+   EXPECT_FALSE(token.stopRequested());
+
+   token.cancel();
+   token.cancel();
+   EXPECT_TRUE(token.isCancelled());
+   EXPECT_TRUE(token.stopRequested());
+   EXPECT_EQ(calls, 1);
+}
+
+TEST(TestCancellationToken, hookAddedAfterCancelRunsAtOnce)
+{
+   CancellationToken token;
+   token.cancel();
+   int calls = 0;
+   token.addHook([&calls]() { ++calls; });
+   EXPECT_EQ(calls, 1);
+}
+
+TEST(TestCancellationToken, removedHookDoesNotRun)
+{
+   CancellationToken token;
+   int calls = 0;
+   token.removeHook(token.addHook([&calls]() { ++calls; }));
+   token.cancel();
+   EXPECT_EQ(calls, 0);
+}
+
+TEST(TestCancellationToken, expiresAtDeadline)
+{
+   const auto deadline = CancellationToken::Clock::now() + std::chrono::milliseconds(20);
+   CancellationToken token{ deadline };
+   EXPECT_FALSE(token.isExpired());
+   EXPECT_EQ(token.limitDeadline(deadline + std::chrono::seconds(1)), deadline);
+   EXPECT_EQ(token.limitDeadline(deadline - std::chrono::seconds(1)), deadline - std::chrono::seconds(1));
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(40));
+   EXPECT_TRUE(token.isExpired());
+   EXPECT_TRUE(token.stopRequested());
+   EXPECT_FALSE(token.isCancelled());
+}
+
+TEST(TestCancellationToken, scopeSetsCurrentToken)
+{
+   CancellationToken outer;
+   CancellationToken inner;
+   EXPECT_EQ(CancellationToken::current(), nullptr);
+   {
+      CancellationToken::Scope outerScope(&outer);
+      {
+         CancellationToken::Scope innerScope(&inner);
+         EXPECT_EQ(CancellationToken::current(), &inner);
+      }
+      EXPECT_EQ(CancellationToken::current(), &outer);
+      std::thread([]() { EXPECT_EQ(CancellationToken::current(), nullptr); }).join();
+   }
+   EXPECT_EQ(CancellationToken::current(), nullptr);
+}
+
+} //proxy
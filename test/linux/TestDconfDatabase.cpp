@@ -0,0 +1,115 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "DconfDatabase.hpp"
+
+#include <fstream>
+
+namespace proxy {
+
+namespace {
+
+const std::string dconf_fixtures{ std::string(PROXY_TEST_FIXTURES_DIR) + "/dconf" };
+const std::string manual_database{ dconf_fixtures + "/manual.gvdb" };
+const std::string auto_database{ dconf_fixtures + "/auto.gvdb" };
+const std::string nomode_database{ dconf_fixtures + "/nomode.gvdb" };
+const std::string hostnoport_database{ dconf_fixtures + "/hostnoport.gvdb" };
+
+} //namespace
+
+TEST(TestDconfDatabase, readsTypedValues)
+{
+   DconfDatabase database{ manual_database };
+   ASSERT_TRUE(database.isOpen());
+
+   EXPECT_EQ(database.readString("/system/proxy/mode"), std::optional<std::string_view>("manual"));
+   EXPECT_EQ(database.readString("/system/proxy/http/host"), std::optional<std::string_view>("httpproxy.com"));
+   EXPECT_EQ(database.readInt32("/system/proxy/http/port"), std::optional<int32_t>(8080));
+   EXPECT_EQ(database.readInt32("/system/proxy/https/port"), std::optional<int32_t>(3333));
+   auto ignoreHosts = database.readStringArray("/system/proxy/ignore-hosts");
+   ASSERT_TRUE(ignoreHosts.has_value());
+   EXPECT_THAT(*ignoreHosts, testing::ElementsAre("localhost", "127.0.0.0/8", "::1"));
+}
+
+TEST(TestDconfDatabase, missingKeysAndTypeMismatches)
+{
+   DconfDatabase database{ manual_database };
+   ASSERT_TRUE(database.isOpen());
+
+   EXPECT_FALSE(database.readString("/system/proxy/autoconfig-url").has_value());
+   EXPECT_FALSE(database.readString("/system/proxy/ftp/host").has_value());
+   EXPECT_FALSE(database.readInt32("/system/proxy/mode").has_value());
+   EXPECT_FALSE(database.readString("/system/proxy/http/port").has_value());
+   //directories are not values
+   EXPECT_FALSE(database.readString("/system/proxy/").has_value());
+   EXPECT_FALSE(database.readString("mode").has_value());
+}
+
+TEST(TestDconfDatabase, emptyStringArray)
+{
+   DconfDatabase database{ auto_database };
+   ASSERT_TRUE(database.isOpen());
+
+   auto ignoreHosts = database.readStringArray("/system/proxy/ignore-hosts");
+   ASSERT_TRUE(ignoreHosts.has_value());
+   EXPECT_TRUE(ignoreHosts->empty());
+}
+
+TEST(TestDconfDatabase, rejectsMissingAndInvalidFiles)
+{
+   EXPECT_FALSE(DconfDatabase{ dconf_fixtures + "/does-not-exist" }.isOpen());
+
+   const std::string garbage{ testing::TempDir() + "/garbage.gvdb" };
+   std::ofstream(garbage) << "this is not a gvdb file at all";
+   EXPECT_FALSE(DconfDatabase{ garbage }.isOpen());
+   EXPECT_FALSE(readDconfProxySettings(garbage).has_value());
+}
+
+TEST(TestDconfDatabase, readsManualProxySettings)
+{
+   auto settings = readDconfProxySettings(manual_database);
+   ASSERT_TRUE(settings.has_value());
+   EXPECT_EQ(settings->mode, "manual");
+   EXPECT_THAT(settings->ignoreHosts, testing::ElementsAre("localhost", "127.0.0.0/8", "::1"));
+   EXPECT_EQ(settings->http.host, "httpproxy.com");
+   EXPECT_EQ(settings->http.port, 8080);
+   EXPECT_EQ(settings->https.host, "httpsproxy.com");
+   EXPECT_EQ(settings->https.port, 3333);
+   EXPECT_EQ(settings->socks.host, "socksproxy.com");
+   EXPECT_EQ(settings->socks.port, 0);
+   EXPECT_TRUE(settings->ftp.host.empty());
+}
+
+TEST(TestDconfDatabase, readsAutoProxySettings)
+{
+   auto settings = readDconfProxySettings(auto_database);
+   ASSERT_TRUE(settings.has_value());
+   EXPECT_EQ(settings->mode, "auto");
+   EXPECT_EQ(settings->autoconfigUrl, "http://wpad.example.com/wpad.dat");
+}
+
+TEST(TestDconfDatabase, missingPortsHaveTheSchemaDefaults)
+{
+   auto settings = readDconfProxySettings(hostnoport_database);
+   ASSERT_TRUE(settings.has_value());
+   EXPECT_EQ(settings->mode, "manual");
+   EXPECT_EQ(settings->http.host, "httpproxy.com");
+   EXPECT_EQ(settings->http.port, 8080);
+   EXPECT_EQ(settings->https.host, "httpsproxy.com");
+   EXPECT_EQ(settings->https.port, 0);
+   EXPECT_TRUE(settings->socks.host.empty());
+   EXPECT_EQ(settings->socks.port, 0);
+}
+
+TEST(TestDconfDatabase, databaseWithoutModeIsNotUsed)
+{
+   EXPECT_FALSE(readDconfProxySettings(nomode_database).has_value());
+}
+
+} //proxy
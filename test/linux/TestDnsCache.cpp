@@ -0,0 +1,183 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "DnsCache.hpp"
+#include "CancellationToken.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using testing::ElementsAre;
+using testing::Optional;
+
+namespace proxy {
+
+namespace {
+
+const std::vector<std::string> address_a{ "192.0.2.1" };
+const std::vector<std::string> unresolvable{};
+
+//counts the lookups of each host, names starting with "dead" do not resolve
+class CountingResolver
+{
+public:
+   std::vector<std::string> operator()(const std::string& host)
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++lookups_[host];
+      return host.rfind("dead", 0) == 0 ? unresolvable : address_a;
+   }
+
+   int lookups(const std::string& host)
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return lookups_[host];
+   }
+
+   DnsCache::Resolver resolver()
+   {
+      return [this](const std::string& host) { return (*this)(host); };
+   }
+
+private:
+   std::mutex mutex_;
+   std::map<std::string, int> lookups_;
+};
+
+DnsCache::Clock::time_point inFiveSeconds()
+{
+   return DnsCache::Clock::now() + std::chrono::seconds(5);
+}
+
+} //namespace
+
+TEST(TestDnsCache, eachHostIsLookedUpOnce)
+{
+   CountingResolver resolver;
+   DnsCache cache{ std::chrono::seconds(60), std::chrono::seconds(5), resolver.resolver() };
+
+   EXPECT_THAT(cache.resolve({ "a.com", "a.com", "dead.com" }, inFiveSeconds()),
+               ElementsAre(Optional(address_a), Optional(address_a), Optional(unresolvable)));
+   EXPECT_THAT(cache.resolve({ "dead.com", "a.com" }, inFiveSeconds()),
+               ElementsAre(Optional(unresolvable), Optional(address_a)));
+   EXPECT_EQ(resolver.lookups("a.com"), 1);
+   EXPECT_EQ(resolver.lookups("dead.com"), 1);
+   EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(TestDnsCache, hostsAreLookedUpInParallel)
+{
+   //each lookup only ends once both have started
+   std::atomic<int> started{ 0 };
+   DnsCache cache{ std::chrono::seconds(60), std::chrono::seconds(5), [&started](const std::string&) {
+      ++started;
+      const auto giveUpAt = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (started < 2 && std::chrono::steady_clock::now() < giveUpAt) {
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      return started >= 2 ? address_a : unresolvable;
+   } };
+
+   EXPECT_THAT(cache.resolve({ "a.com", "b.com" }, inFiveSeconds()), ElementsAre(Optional(address_a), Optional(address_a)));
+}
+
+TEST(TestDnsCache, unresolvableHostIsLookedUpAgainSooner)
+{
+   CountingResolver resolver;
+   DnsCache cache{ std::chrono::seconds(60), std::chrono::milliseconds(20), resolver.resolver() };
+
+   cache.resolve({ "a.com", "dead.com" }, inFiveSeconds());
+   std::this_thread::sleep_for(std::chrono::milliseconds(40));
+   cache.resolve({ "a.com", "dead.com" }, inFiveSeconds());
+   EXPECT_EQ(resolver.lookups("a.com"), 1);
+   EXPECT_EQ(resolver.lookups("dead.com"), 2);
+}
+
+TEST(TestDnsCache, failedLookupIsNotRemembered)
+{
+   std::atomic<int> lookups{ 0 };
+   DnsCache cache{ std::chrono::seconds(60), std::chrono::seconds(5), [&lookups](const std::string&) {
+      ++lookups;
+      return std::optional<std::vector<std::string>>{};
+   } };
+
+   EXPECT_THAT(cache.resolve({ "a.com" }, inFiveSeconds()), ElementsAre(std::nullopt));
+   EXPECT_THAT(cache.resolve({ "a.com" }, inFiveSeconds()), ElementsAre(std::nullopt));
+   EXPECT_EQ(lookups, 2);
+   EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(TestDnsCache, destructionWaitsForRunningLookups)
+{
+   std::promise<void> started;
+   std::atomic<bool> ended{ false };
+   {
+      DnsCache cache{ std::chrono::seconds(60), std::chrono::seconds(5), [&started, &ended](const std::string&) {
+         started.set_value();
+         std::this_thread::sleep_for(std::chrono::milliseconds(20));
+         ended = true;
+         return address_a;
+      } };
+      CancellationToken token;
+      token.cancel();
+      CancellationToken::Scope scope(&token);
+      cache.resolve({ "a.com" }, inFiveSeconds());
+      started.get_future().wait();
+   }
+   EXPECT_TRUE(ended);
+}
+
+TEST(TestDnsCache, slowLookupIsRememberedAfterTheDeadline)
+{
+   std::promise<void> release;
+   std::shared_future<void> released{ release.get_future().share() };
+   DnsCache cache{ std::chrono::seconds(60), std::chrono::seconds(5), [released](const std::string&) {
+      released.wait();
+      return address_a;
+   } };
+
+   const auto start = DnsCache::Clock::now();
+   EXPECT_THAT(cache.resolve({ "a.com" }, start + std::chrono::milliseconds(50)), ElementsAre(std::nullopt));
+   EXPECT_LT(DnsCache::Clock::now() - start, std::chrono::seconds(5));
+
+   release.set_value();
+   EXPECT_THAT(cache.resolve({ "a.com" }, inFiveSeconds()), ElementsAre(Optional(address_a)));
+}
+
+TEST(TestDnsCache, cancelledRequestStopsWaiting)
+{
+   std::promise<void> release;
+   std::shared_future<void> released{ release.get_future().share() };
+   DnsCache cache{ std::chrono::seconds(60), std::chrono::seconds(5), [released](const std::string&) {
+      released.wait();
+      return address_a;
+   } };
+
+   CancellationToken token;
+   token.cancel();
+   CancellationToken::Scope scope(&token);
+   const auto start = DnsCache::Clock::now();
+   EXPECT_THAT(cache.resolve({ "a.com" }, inFiveSeconds()), ElementsAre(std::nullopt));
+   EXPECT_LT(DnsCache::Clock::now() - start, std::chrono::seconds(1));
+   release.set_value();
+}
+
+TEST(TestDnsCache, resolvesLocalhost)
+{
+   EXPECT_THAT(DnsCache::resolveHost("localhost"), Optional(testing::Not(testing::IsEmpty())));
+   EXPECT_THAT(DnsCache::resolveHost("127.0.0.1"), Optional(ElementsAre("127.0.0.1")));
+   //without a name server the lookup fails instead of finding out that the name does not exist
+   EXPECT_THAT(DnsCache::resolveHost("host.invalid"), testing::AnyOf(testing::Eq(std::nullopt), Optional(testing::IsEmpty())));
+}
+
+} //proxy
@@ -0,0 +1,149 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "CancellationToken.hpp"
+#include "DuktapePacRuntime.hpp"
+#include "PacEngine.hpp"
+
+#include <duktape.h>
+#include <thread>
+
+namespace proxy {
+
+namespace {
+
+//runs expression in FindProxyForURL with the PAC helper functions and returns its value as a string
+std::optional<std::string> evaluate(const std::string& expression, const std::string& host = "www.corp.com")
+{
+   DuktapePacRuntime runtime;
+   auto script = runtime.compile("function FindProxyForURL(url, host) { return String(" + expression + "); }");
+   if (!script) {
+      return std::nullopt;
+   }
+   return script->findProxyForUrl("https://" + host + "/", host);
+}
+
+} //namespace
+
+TEST(TestDuktapePacRuntime, hostHelpers)
+{
+   EXPECT_EQ(evaluate("isPlainHostName(host)", "intranet"), "true");
+   EXPECT_EQ(evaluate("isPlainHostName(host)"), "false");
+   EXPECT_EQ(evaluate("dnsDomainIs(host, '.corp.com')"), "true");
+   EXPECT_EQ(evaluate("dnsDomainIs(host, '.other.com')"), "false");
+   EXPECT_EQ(evaluate("dnsDomainLevels(host)"), "2");
+   EXPECT_EQ(evaluate("localHostOrDomainIs('www', host)"), "true");
+   EXPECT_EQ(evaluate("localHostOrDomainIs('ftp', host)"), "false");
+}
+
+TEST(TestDuktapePacRuntime, shExpMatch)
+{
+   EXPECT_EQ(evaluate("shExpMatch(host, '*.corp.com')"), "true");
+   EXPECT_EQ(evaluate("shExpMatch(host, 'ww?.corp.com')"), "true");
+   EXPECT_EQ(evaluate("shExpMatch(host, '*.corp.co')"), "false");
+   //regular expression characters in the pattern are taken literally
+   EXPECT_EQ(evaluate("shExpMatch('a+b', 'a+b')"), "true");
+   EXPECT_EQ(evaluate("shExpMatch('aab', 'a+b')"), "false");
+}
+
+TEST(TestDuktapePacRuntime, addressHelpers)
+{
+   EXPECT_EQ(evaluate("dnsResolve(host)", "127.0.0.1"), "127.0.0.1");
+   EXPECT_EQ(evaluate("dnsResolve('')"), "null");
+   EXPECT_EQ(evaluate("isResolvable(host)", "127.0.0.1"), "true");
+   EXPECT_EQ(evaluate("isInNet(host, '127.0.0.0', '255.0.0.0')", "127.0.0.1"), "true");
+   EXPECT_EQ(evaluate("isInNet(host, '10.0.0.0', '255.0.0.0')", "127.0.0.1"), "false");
+   EXPECT_THAT(evaluate("myIpAddress()"), testing::Optional(testing::Not(testing::IsEmpty())));
+}
+
+TEST(TestDuktapePacRuntime, timeHelpersAcceptTheirWholeRange)
+{
+   EXPECT_EQ(evaluate("weekdayRange('SUN', 'SAT')"), "true");
+   EXPECT_EQ(evaluate("dateRange(1, 31)"), "true");
+   EXPECT_EQ(evaluate("timeRange(0, 23)"), "true");
+}
+
+TEST(TestDuktapePacRuntime, brokenScriptsDoNotCompile)
+{
+   DuktapePacRuntime runtime;
+   EXPECT_EQ(runtime.compile("function FindProxyForURL(url, host) { return"), nullptr);
+   EXPECT_EQ(runtime.compile("var proxy = 'DIRECT';"), nullptr);
+}
+
+TEST(TestDuktapePacRuntime, throwingScriptFails)
+{
+   DuktapePacRuntime runtime;
+   auto script = runtime.compile("function FindProxyForURL(url, host) { throw new Error('broken'); }");
+   ASSERT_NE(script, nullptr);
+   EXPECT_EQ(script->findProxyForUrl("https://www.corp.com/", "www.corp.com"), std::nullopt);
+}
+
+TEST(TestDuktapePacRuntime, stoppedRequestIsNotEvaluated)
+{
+   DuktapePacRuntime runtime;
+   auto script = runtime.compile("function FindProxyForURL(url, host) { return 'DIRECT'; }");
+   ASSERT_NE(script, nullptr);
+
+   CancellationToken token;
+   CancellationToken::Scope scope{ &token };
+   EXPECT_EQ(script->findProxyForUrl("https://www.corp.com/", "www.corp.com"), "DIRECT");
+   token.cancel();
+   EXPECT_EQ(script->findProxyForUrl("https://www.corp.com/", "www.corp.com"), std::nullopt);
+}
+
+TEST(TestDuktapePacRuntime, loopingScriptTimesOut)
+{
+#ifndef DUK_USE_EXEC_TIMEOUT_CHECK
+   GTEST_SKIP() << "Duktape is built without DUK_USE_EXEC_TIMEOUT_CHECK";
+#endif
+   DuktapePacRuntime runtime{ std::chrono::milliseconds(200) };
+   auto script = runtime.compile("function FindProxyForURL(url, host) { while (true) {} }");
+   ASSERT_NE(script, nullptr);
+   EXPECT_EQ(script->findProxyForUrl("https://www.corp.com/", "www.corp.com"), std::nullopt);
+   //a script looping at its top level does not compile
+   EXPECT_EQ(runtime.compile("while (true) {}"), nullptr);
+}
+
+TEST(TestDuktapePacRuntime, loopingScriptStopsOnCancellation)
+{
+#ifndef DUK_USE_EXEC_TIMEOUT_CHECK
+   GTEST_SKIP() << "Duktape is built without DUK_USE_EXEC_TIMEOUT_CHECK";
+#endif
+   DuktapePacRuntime runtime{ std::chrono::minutes(10) };
+   auto script = runtime.compile("function FindProxyForURL(url, host) { while (true) {} }");
+   ASSERT_NE(script, nullptr);
+
+   CancellationToken token;
+   CancellationToken::Scope scope{ &token };
+   std::thread canceller([&token] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      token.cancel();
+   });
+   const auto started = std::chrono::steady_clock::now();
+   EXPECT_EQ(script->findProxyForUrl("https://www.corp.com/", "www.corp.com"), std::nullopt);
+   EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(10));
+   canceller.join();
+}
+
+TEST(TestDuktapePacRuntime, engineFindsProxiesOfTheScript)
+{
+   PacEngine engine{ std::make_shared<DuktapePacRuntime>() };
+   const std::string script{
+      "function FindProxyForURL(url, host) {\n"
+      "   if (isPlainHostName(host) || dnsDomainIs(host, '.corp.com')) return 'DIRECT';\n"
+      "   return 'PROXY proxy.corp.com:3128; SOCKS socks.corp.com; DIRECT';\n"
+      "}\n" };
+
+   EXPECT_TRUE(engine.findProxies(script, "https://www.corp.com/").empty());
+   const ProxyRecords expected{ { "http://proxy.corp.com:3128", 3128, ProxyTypes::HTTP },
+                                { "socks5://socks.corp.com:1080", 1080, ProxyTypes::SOCKS } };
+   EXPECT_EQ(engine.findProxies(script, "https://example.com/"), expected);
+}
+
+} //proxy
@@ -0,0 +1,80 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "GnomeProxySettings.hpp"
+
+namespace proxy {
+
+TEST(TestGnomeProxySettings, parsesManualListing)
+{
+   const std::string listing =
+      "org.gnome.system.proxy autoconfig-url ''\n"
+      "org.gnome.system.proxy ignore-hosts ['localhost', '127.0.0.0/8', '::1']\n"
+      "org.gnome.system.proxy mode 'manual'\n"
+      "org.gnome.system.proxy use-same-proxy true\n"
+      "org.gnome.system.proxy.ftp host 'ftpproxy.com'\n"
+      "org.gnome.system.proxy.ftp port 2121\n"
+      "org.gnome.system.proxy.http authentication-user ''\n"
+      "org.gnome.system.proxy.http host 'httpproxy.com'\n"
+      "org.gnome.system.proxy.http port 8080\n"
+      "org.gnome.system.proxy.https host 'httpsproxy.com'\n"
+      "org.gnome.system.proxy.https port 3333\n"
+      "org.gnome.system.proxy.socks host 'socksproxy.com'\n"
+      "org.gnome.system.proxy.socks port 1080\n";
+
+   const GnomeProxySettings settings = parseGsettingsListing(listing);
+   EXPECT_EQ(settings.mode, "manual");
+   EXPECT_EQ(settings.autoconfigUrl, "");
+   EXPECT_THAT(settings.ignoreHosts, testing::ElementsAre("localhost", "127.0.0.0/8", "::1"));
+   EXPECT_EQ(settings.http.host, "httpproxy.com");
+   EXPECT_EQ(settings.http.port, 8080);
+   EXPECT_EQ(settings.https.host, "httpsproxy.com");
+   EXPECT_EQ(settings.https.port, 3333);
+   EXPECT_EQ(settings.ftp.host, "ftpproxy.com");
+   EXPECT_EQ(settings.ftp.port, 2121);
+   EXPECT_EQ(settings.socks.host, "socksproxy.com");
+   EXPECT_EQ(settings.socks.port, 1080);
+}
+
+TEST(TestGnomeProxySettings, parsesAutoListing)
+{
+   const std::string listing =
+      "org.gnome.system.proxy autoconfig-url 'http://wpad.example.com/wpad.dat'\n"
+      "org.gnome.system.proxy ignore-hosts @as []\n"
+      "org.gnome.system.proxy mode 'auto'\n";
+
+   const GnomeProxySettings settings = parseGsettingsListing(listing);
+   EXPECT_EQ(settings.mode, "auto");
+   EXPECT_EQ(settings.autoconfigUrl, "http://wpad.example.com/wpad.dat");
+   EXPECT_TRUE(settings.ignoreHosts.empty());
+   EXPECT_TRUE(settings.http.host.empty());
+   EXPECT_EQ(settings.http.port, 0);
+}
+
+TEST(TestGnomeProxySettings, handlesQuotingAndTypeAnnotations)
+{
+   const std::string listing =
+      "org.gnome.system.proxy ignore-hosts ['it\\'s.local', \"quote'd.local\"]\n"
+      "org.gnome.system.proxy.http host 'httpproxy.com'\r\n"
+      "org.gnome.system.proxy.http port uint32 8080\n"
+      "org.gnome.system.proxy.https port 99999\n"
+      "org.gnome.system.proxy.socks port 'abc'\n"
+      "org.gnome.desktop.other mode 'manual'\n"
+      "garbage\n";
+
+   const GnomeProxySettings settings = parseGsettingsListing(listing);
+   EXPECT_EQ(settings.mode, "");
+   EXPECT_THAT(settings.ignoreHosts, testing::ElementsAre("it's.local", "quote'd.local"));
+   EXPECT_EQ(settings.http.host, "httpproxy.com");
+   EXPECT_EQ(settings.http.port, 8080);
+   EXPECT_EQ(settings.https.port, 0);
+   EXPECT_EQ(settings.socks.port, 0);
+}
+
+} //proxy
@@ -0,0 +1,65 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+
+#include "KdeProxySettings.hpp"
+
+namespace proxy {
+
+namespace {
+
+const std::string kde_fixtures{ std::string(PROXY_TEST_FIXTURES_DIR) + "/kde" };
+
+} //namespace
+
+TEST(TestKdeProxySettings, readsManualSettings)
+{
+   auto settings = readKioslaverc(kde_fixtures + "/manual/kioslaverc");
+   ASSERT_TRUE(settings.has_value());
+   EXPECT_EQ(settings->proxyType, KdeProxyType::Manual);
+   EXPECT_EQ(settings->httpProxy, "http://httpproxy.com 8080");
+   EXPECT_EQ(settings->httpsProxy, "http://httpsproxy.com:3333");
+   EXPECT_EQ(settings->ftpProxy, "");
+   EXPECT_EQ(settings->socksProxy, "socks://socksproxy.com 1080");
+   EXPECT_EQ(settings->noProxyFor, "localhost,127.0.0.1,.example.com");
+   EXPECT_EQ(settings->configScriptUrl, "");
+}
+
+TEST(TestKdeProxySettings, readsConfigScriptSettings)
+{
+   auto settings = readKioslaverc(kde_fixtures + "/script/kioslaverc");
+   ASSERT_TRUE(settings.has_value());
+   EXPECT_EQ(settings->proxyType, KdeProxyType::ConfigScript);
+   EXPECT_EQ(settings->configScriptUrl, "http://wpad.example.com/wpad.dat");
+}
+
+TEST(TestKdeProxySettings, readsEnvironmentSettings)
+{
+   auto settings = readKioslaverc(kde_fixtures + "/environment/kioslaverc");
+   ASSERT_TRUE(settings.has_value());
+   EXPECT_EQ(settings->proxyType, KdeProxyType::Environment);
+   EXPECT_EQ(settings->httpProxy, "CORP_HTTP_PROXY");
+   EXPECT_EQ(settings->ftpProxy, "FTP_PROXY");
+}
+
+TEST(TestKdeProxySettings, missingFile)
+{
+   EXPECT_FALSE(readKioslaverc(kde_fixtures + "/missing/kioslaverc").has_value());
+}
+
+TEST(TestKdeProxySettings, parsesWithoutTrailingNewlineAndSkipsOtherGroups)
+{
+   auto settings = parseKioslaverc("[General]\nProxyType=1\n[Proxy Settings]\r\n ProxyType = 1 \r\nhttpProxy=http://\\sproxy.com 8080");
+   EXPECT_EQ(settings.proxyType, KdeProxyType::Manual);
+   EXPECT_EQ(settings.httpProxy, "http:// proxy.com 8080");
+
+   EXPECT_EQ(parseKioslaverc("[General]\nProxyType=1\n").proxyType, KdeProxyType::None);
+   EXPECT_EQ(parseKioslaverc("[Proxy Settings]\nProxyType=9\n").proxyType, KdeProxyType::None);
+   EXPECT_EQ(parseKioslaverc("").proxyType, KdeProxyType::None);
+}
+
+} //proxy
@@ -0,0 +1,70 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+
+#include "LatencyTracker.hpp"
+
+using std::chrono::microseconds;
+
+namespace proxy {
+
+namespace {
+
+const ProxyRecord proxy_a{ "http://a.com:8080", 8080, ProxyTypes::HTTP };
+const ProxyRecord proxy_b{ "http://b.com:8080", 8080, ProxyTypes::HTTP };
+const ProxyRecord proxy_c{ "http://c.com:8080", 8080, ProxyTypes::HTTP };
+
+ProxyLatency measured(int connect, int firstByte)
+{
+   ProxyLatency latency;
+   latency.connect = microseconds(connect);
+   latency.firstByte = microseconds(firstByte);
+   latency.score = microseconds(firstByte);
+   return latency;
+}
+
+} //namespace
+
+TEST(TestLatencyTracker, firstMeasurementIsTheAverage)
+{
+   LatencyTracker tracker;
+   EXPECT_FALSE(tracker.latency(proxy_a));
+
+   tracker.record(proxy_a, measured(100, 1000));
+   const auto latency = tracker.latency(proxy_a);
+   ASSERT_TRUE(latency);
+   EXPECT_EQ(latency->connect, microseconds(100));
+   EXPECT_EQ(latency->score, microseconds(1000));
+   EXPECT_FALSE(tracker.latency(proxy_b));
+}
+
+TEST(TestLatencyTracker, laterMeasurementsAreSmoothed)
+{
+   LatencyTracker tracker{ 0.5 };
+   tracker.record(proxy_a, measured(100, 1000));
+   tracker.record(proxy_a, measured(300, 2000));
+   const auto latency = tracker.latency(proxy_a);
+   ASSERT_TRUE(latency);
+   EXPECT_EQ(latency->connect, microseconds(200));
+   EXPECT_EQ(latency->firstByte, microseconds(1500));
+   EXPECT_EQ(latency->score, microseconds(1500));
+}
+
+TEST(TestLatencyTracker, oldestMeasuredEndpointIsForgotten)
+{
+   LatencyTracker tracker{ 0.3, 2 };
+   tracker.record(proxy_a, measured(100, 1000));
+   tracker.record(proxy_b, measured(100, 1000));
+   tracker.record(proxy_a, measured(100, 1000));
+   tracker.record(proxy_c, measured(100, 1000));
+   EXPECT_EQ(tracker.size(), 2u);
+   EXPECT_TRUE(tracker.latency(proxy_a));
+   EXPECT_FALSE(tracker.latency(proxy_b));
+   EXPECT_TRUE(tracker.latency(proxy_c));
+}
+
+} //proxy
@@ -0,0 +1,95 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "MockProxyObserver.hpp"
+#include "ObserverRegistry.hpp"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using testing::_;
+
+namespace proxy {
+
+void notifyAll(const ObserverRegistry& registry, const std::string& guid)
+{
+   registry.notify([&guid](IProxyObserver& observer) { observer.updateProxyList({}, guid); });
+}
+
+TEST(TestObserverRegistry, observerAddedTwiceIsNotifiedOnce)
+{
+   ObserverRegistry registry;
+   MockProxyObserver observer;
+   registry.add(observer);
+   registry.add(observer);
+   EXPECT_EQ(registry.size(), 1u);
+
+   EXPECT_CALL(observer, updateProxyList(_, "guid")).Times(1);
+   notifyAll(registry, "guid");
+}
+
+TEST(TestObserverRegistry, removedObserverIsNotNotified)
+{
+   ObserverRegistry registry;
+   MockProxyObserver removed;
+   MockProxyObserver kept;
+   registry.add(removed);
+   registry.add(kept);
+   registry.remove(removed);
+   registry.remove(removed);
+   EXPECT_EQ(registry.size(), 1u);
+
+   EXPECT_CALL(removed, updateProxyList(_, _)).Times(0);
+   EXPECT_CALL(kept, updateProxyList(_, "guid"));
+   notifyAll(registry, "guid");
+}
+
+TEST(TestObserverRegistry, removeWaitsForRunningNotification)
+{
+   ObserverRegistry registry;
+   MockProxyObserver observer;
+   registry.add(observer);
+
+   std::promise<void> started;
+   std::promise<void> release;
+   std::shared_future<void> released{ release.get_future().share() };
+   bool finished = false;
+   EXPECT_CALL(observer, updateProxyList(_, "guid")).WillOnce([&](const std::list<ProxyRecord>&, const std::string&) {
+      started.set_value();
+      released.wait();
+      finished = true;
+   });
+
+   std::thread notifier([&registry]() { notifyAll(registry, "guid"); });
+   started.get_future().wait();
+   auto removing = std::async(std::launch::async, [&registry, &observer]() { registry.remove(observer); });
+   EXPECT_EQ(removing.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+
+   release.set_value();
+   removing.get();
+   EXPECT_TRUE(finished);
+   notifier.join();
+}
+
+TEST(TestObserverRegistry, observerCanRemoveItselfWhileNotified)
+{
+   ObserverRegistry registry;
+   MockProxyObserver observer;
+   registry.add(observer);
+
+   EXPECT_CALL(observer, updateProxyList(_, "first")).WillOnce([&registry, &observer](const std::list<ProxyRecord>&, const std::string&) {
+      registry.remove(observer);
+   });
+   EXPECT_CALL(observer, updateProxyList(_, "second")).Times(0);
+   notifyAll(registry, "first");
+   notifyAll(registry, "second");
+}
+
+} //proxy
@@ -0,0 +1,158 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+
+#include "LocalHttpServer.hpp"
+#include "PacFetcher.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+
+namespace proxy {
+
+namespace {
+
+const std::string script_v1{ "function FindProxyForURL(url, host) { return 'PROXY v1.com:3128'; }" };
+const std::string script_v2{ "function FindProxyForURL(url, host) { return 'PROXY v2.com:3128'; }" };
+const std::string last_modified{ "Wed, 21 Oct 2015 07:28:00 GMT" };
+
+} //namespace
+
+class TestPacFetcher : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      std::string dir = (std::filesystem::temp_directory_path() / "pacfetcher.XXXXXX").string();
+      ASSERT_NE(mkdtemp(dir.data()), nullptr);
+      cacheDir_ = dir + "/cache";
+   }
+
+   void TearDown() override
+   {
+      std::filesystem::remove_all(std::filesystem::path(cacheDir_).parent_path());
+   }
+
+   //serves the current script, answering 304 when the client already has it
+   LocalHttpServer::Response serveScript(const LocalHttpServer::Request& request)
+   {
+      LocalHttpServer::Response response;
+      response.delay = delay_;
+      const std::string etag = "\"" + std::to_string(version_.load()) + "\"";
+      response.headers["ETag"] = etag;
+      response.headers["Last-Modified"] = last_modified;
+      const auto ifNoneMatch = request.headers.find("if-none-match");
+      if (ifNoneMatch != request.headers.end() && ifNoneMatch->second == etag) {
+         response.status = 304;
+      } else {
+         response.body = (version_ == 1) ? script_v1 : script_v2;
+      }
+      return response;
+   }
+
+   std::string cacheDir_;
+   std::atomic<int> version_{ 1 };
+   std::chrono::milliseconds delay_{ 0 };
+};
+
+TEST_F(TestPacFetcher, fetchedScriptIsStoredOnDisk)
+{
+   LocalHttpServer server{ [this](const auto& request) { return serveScript(request); } };
+   const std::string url = server.url("/proxy.pac");
+
+   {
+      PacFetcher fetcher{ cacheDir_ };
+      EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+      EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+   }
+   //another process finds the fresh copy and does not ask the server
+   PacFetcher fetcher{ cacheDir_ };
+   EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+   fetcher.waitRevalidations();
+   EXPECT_EQ(server.requests().size(), 1u);
+}
+
+TEST_F(TestPacFetcher, staleCopyIsServedWhileRevalidating)
+{
+   LocalHttpServer server{ [this](const auto& request) { return serveScript(request); } };
+   const std::string url = server.url("/proxy.pac");
+   {
+      PacFetcher fetcher{ cacheDir_, std::chrono::seconds(0) };
+      ASSERT_EQ(fetcher.fetchScript(url), script_v1);
+   }
+
+   delay_ = std::chrono::milliseconds(1000);
+   PacFetcher fetcher{ cacheDir_, std::chrono::seconds(0) };
+   const auto start = std::chrono::steady_clock::now();
+   EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+   fetcher.waitRevalidations();
+
+   const auto requests = server.requests();
+   ASSERT_EQ(requests.size(), 2u);
+   EXPECT_EQ(requests[1].headers.at("if-none-match"), "\"1\"");
+   EXPECT_EQ(requests[1].headers.at("if-modified-since"), last_modified);
+}
+
+TEST_F(TestPacFetcher, changedScriptReplacesCachedCopy)
+{
+   LocalHttpServer server{ [this](const auto& request) { return serveScript(request); } };
+   const std::string url = server.url("/proxy.pac");
+   PacFetcher fetcher{ cacheDir_, std::chrono::seconds(0) };
+   ASSERT_EQ(fetcher.fetchScript(url), script_v1);
+
+   version_ = 2;
+   EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+   fetcher.waitRevalidations();
+   EXPECT_EQ(fetcher.fetchScript(url), script_v2);
+   fetcher.waitRevalidations();
+
+   PacFetcher otherFetcher{ cacheDir_ };
+   EXPECT_EQ(otherFetcher.fetchScript(url), script_v2);
+}
+
+TEST_F(TestPacFetcher, cachedCopyIsServedWhenServerIsUnreachable)
+{
+   std::string url;
+   {
+      LocalHttpServer server{ [this](const auto& request) { return serveScript(request); } };
+      url = server.url("/proxy.pac");
+      PacFetcher fetcher{ cacheDir_ };
+      ASSERT_EQ(fetcher.fetchScript(url), script_v1);
+   }
+
+   PacFetcher fetcher{ cacheDir_, std::chrono::seconds(0), std::chrono::milliseconds(500) };
+   EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+   fetcher.waitRevalidations();
+   EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+}
+
+TEST_F(TestPacFetcher, failedDownloadWithoutCachedCopy)
+{
+   LocalHttpServer server{ [](const auto&) {
+      LocalHttpServer::Response response;
+      response.status = 404;
+      return response;
+   } };
+   PacFetcher fetcher{ cacheDir_ };
+   EXPECT_FALSE(fetcher.fetchScript(server.url("/missing.pac")).has_value());
+   EXPECT_FALSE(std::filesystem::exists(cacheDir_));
+}
+
+TEST_F(TestPacFetcher, memoryOnlyCache)
+{
+   LocalHttpServer server{ [this](const auto& request) { return serveScript(request); } };
+   const std::string url = server.url("/proxy.pac");
+   PacFetcher fetcher{ "" };
+   EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+   EXPECT_EQ(fetcher.fetchScript(url), script_v1);
+   EXPECT_EQ(server.requests().size(), 1u);
+}
+
+} //proxy
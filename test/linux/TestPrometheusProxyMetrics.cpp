@@ -0,0 +1,56 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "PrometheusProxyMetrics.h"
+
+using std::chrono::milliseconds;
+using testing::HasSubstr;
+
+namespace proxy {
+
+TEST(TestPrometheusProxyMetrics, countersAreRenderedPerLabels)
+{
+   PrometheusProxyMetrics metrics;
+   EXPECT_EQ(metrics.render(), "");
+
+   metrics.incrementCounter("lookups_total", { { "cache", "dns" }, { "result", "hit" } });
+   metrics.incrementCounter("lookups_total", { { "cache", "dns" }, { "result", "hit" } });
+   metrics.incrementCounter("lookups_total", { { "cache", "dns" }, { "result", "miss" } });
+   metrics.incrementCounter("runs_total", {});
+   EXPECT_EQ(metrics.render(),
+             "# TYPE lookups_total counter\n"
+             "lookups_total{cache=\"dns\",result=\"hit\"} 2\n"
+             "lookups_total{cache=\"dns\",result=\"miss\"} 1\n"
+             "# TYPE runs_total counter\n"
+             "runs_total 1\n");
+}
+
+TEST(TestPrometheusProxyMetrics, durationsAreRenderedAsHistograms)
+{
+   PrometheusProxyMetrics metrics{ { 0.1, 0.01 } };
+   metrics.observeDuration("request_seconds", { { "kind", "sync" } }, milliseconds(5));
+   metrics.observeDuration("request_seconds", { { "kind", "sync" } }, milliseconds(50));
+   metrics.observeDuration("request_seconds", { { "kind", "sync" } }, milliseconds(500));
+   EXPECT_EQ(metrics.render(),
+             "# TYPE request_seconds histogram\n"
+             "request_seconds_bucket{kind=\"sync\",le=\"0.01\"} 1\n"
+             "request_seconds_bucket{kind=\"sync\",le=\"0.1\"} 2\n"
+             "request_seconds_bucket{kind=\"sync\",le=\"+Inf\"} 3\n"
+             "request_seconds_sum{kind=\"sync\"} 0.555\n"
+             "request_seconds_count{kind=\"sync\"} 3\n");
+}
+
+TEST(TestPrometheusProxyMetrics, labelValuesAreEscaped)
+{
+   PrometheusProxyMetrics metrics;
+   metrics.incrementCounter("runs_total", { { "command", "a\"b\\c\nd" } });
+   EXPECT_THAT(metrics.render(), HasSubstr("runs_total{command=\"a\\\"b\\\\c\\nd\"} 1\n"));
+}
+
+} //proxy
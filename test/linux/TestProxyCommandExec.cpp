@@ -0,0 +1,118 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+
+#include "ProxyCommandExec.hpp"
+#include "CancellationToken.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+const std::string sh{ "/bin/sh" };
+
+CommandOutput runShell(ProxyCommandExec &executor, const std::string &script)
+{
+   return executor.ExecuteCommandCaptureOutput(sh, {sh, "-c", script});
+}
+
+} //namespace
+
+TEST(TestProxyCommandExec, capturesOutputAndExitCode)
+{
+   ProxyCommandExec executor;
+   const auto result = runShell(executor, "echo proxy; exit 3");
+   EXPECT_EQ(result.exitCode_, 3);
+   EXPECT_EQ(result.output_, "proxy\n");
+   EXPECT_EQ(result.error_, "");
+}
+
+TEST(TestProxyCommandExec, capturesOutputLargerThanPipeBuffer)
+{
+   ProxyCommandExec executor;
+   const auto result = runShell(executor, "head -c 1000000 /dev/zero");
+   EXPECT_EQ(result.exitCode_, 0);
+   EXPECT_EQ(result.output_.size(), 1000000u);
+}
+
+TEST(TestProxyCommandExec, capturesStderrWhenAsked)
+{
+   ProxyCommandExec executor{std::chrono::seconds(5), true};
+   const auto result = runShell(executor, "echo out; echo err >&2");
+   EXPECT_EQ(result.output_, "out\n");
+   EXPECT_EQ(result.error_, "err\n");
+}
+
+TEST(TestProxyCommandExec, terminatesCommandAtDeadline)
+{
+   ProxyCommandExec executor{std::chrono::milliseconds(200)};
+   const auto start = std::chrono::steady_clock::now();
+   EXPECT_THROW(runShell(executor, "sleep 30"), std::runtime_error);
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(TestProxyCommandExec, killsCommandIgnoringSigterm)
+{
+   ProxyCommandExec executor{std::chrono::milliseconds(200)};
+   const auto start = std::chrono::steady_clock::now();
+   EXPECT_THROW(runShell(executor, "trap '' TERM; while :; do :; done"), std::runtime_error);
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(TestProxyCommandExec, rejectsRelativeCommand)
+{
+   ProxyCommandExec executor;
+   EXPECT_THROW(executor.ExecuteCommandCaptureOutput("sh", {"sh"}), std::runtime_error);
+}
+
+TEST(TestProxyCommandExec, terminatesCommandOfCancelledRequest)
+{
+   ProxyCommandExec executor;
+   proxy::CancellationToken token;
+   std::thread canceller([&token]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      token.cancel();
+   });
+
+   const auto start = std::chrono::steady_clock::now();
+   {
+      proxy::CancellationToken::Scope scope(&token);
+      EXPECT_THROW(runShell(executor, "sleep 30"), std::runtime_error);
+   }
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+   canceller.join();
+}
+
+TEST(TestProxyCommandExec, terminatesCommandWithClosedOutputOfCancelledRequest)
+{
+   ProxyCommandExec executor;
+   proxy::CancellationToken token;
+   std::thread canceller([&token]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      token.cancel();
+   });
+
+   const auto start = std::chrono::steady_clock::now();
+   {
+      proxy::CancellationToken::Scope scope(&token);
+      EXPECT_THROW(runShell(executor, "exec >&-; sleep 30"), std::runtime_error);
+   }
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+   canceller.join();
+}
+
+TEST(TestProxyCommandExec, requestDeadlineShortensTimeout)
+{
+   ProxyCommandExec executor{std::chrono::seconds(30)};
+   proxy::CancellationToken token{std::chrono::steady_clock::now() + std::chrono::milliseconds(100)};
+   proxy::CancellationToken::Scope scope(&token);
+
+   const auto start = std::chrono::steady_clock::now();
+   EXPECT_THROW(runShell(executor, "sleep 30"), std::runtime_error);
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
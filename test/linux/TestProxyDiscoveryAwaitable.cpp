@@ -0,0 +1,85 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "MockCommandExec.hpp"
+#include "MockProxyVerifier.hpp"
+#include "ProxyDiscoveryEngine.hpp"
+#include "ProxyDiscoveryAwaitable.h"
+
+#include <coroutine>
+#include <future>
+
+using testing::Return;
+using testing::_;
+
+namespace proxy {
+
+namespace {
+
+//a coroutine that starts at once and hands its result to a future
+struct FutureTask
+{
+   struct promise_type
+   {
+      std::promise<size_t> result;
+
+      FutureTask get_return_object()
+      {
+         return FutureTask{ result.get_future() };
+      }
+      std::suspend_never initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_value(size_t value) { result.set_value(value); }
+      void unhandled_exception() { result.set_exception(std::current_exception()); }
+   };
+
+   std::future<size_t> result;
+};
+
+FutureTask countProxies(IProxyDiscoveryEngine& engine, std::optional<std::chrono::milliseconds> timeout)
+{
+   const ProxyRecords proxies = co_await discoverProxies(engine, "test_url", "", "guid", timeout);
+   co_return proxies.size();
+}
+
+} //namespace
+
+TEST(TestProxyDiscoveryAwaitable, awaitsProxies)
+{
+   auto commandExecutor = std::make_shared<MockCommandExec>();
+   auto proxyVerifier = std::make_shared<MockProxyVerifier>();
+   EXPECT_CALL(*commandExecutor, getEnvironmentVar(_)).WillRepeatedly(Return(""));
+   EXPECT_CALL(*commandExecutor, getEnvironmentVar("http_proxy")).WillRepeatedly(Return("http://httpproxy.com:8080"));
+   EXPECT_CALL(*proxyVerifier, verifyProxy(_,_)).WillRepeatedly(Return(true));
+   ProxyDiscoveryEngine engine(commandExecutor, proxyVerifier);
+
+   std::vector<FutureTask> tasks;
+   for (int i = 0; i < 4; ++i) {
+      tasks.push_back(countProxies(engine, std::nullopt));
+   }
+   for (auto& task : tasks) {
+      ASSERT_EQ(task.result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+      EXPECT_EQ(task.result.get(), 1u);
+   }
+}
+
+TEST(TestProxyDiscoveryAwaitable, awaitThrowsWhenCancelled)
+{
+   auto commandExecutor = std::make_shared<MockCommandExec>();
+   auto proxyVerifier = std::make_shared<MockProxyVerifier>();
+   EXPECT_CALL(*commandExecutor, getEnvironmentVar(_)).WillRepeatedly(Return(""));
+   ProxyDiscoveryEngine engine(commandExecutor, proxyVerifier);
+
+   //a request past its deadline before it starts ends without running
+   FutureTask task = countProxies(engine, std::chrono::milliseconds(0));
+   ASSERT_EQ(task.result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+   EXPECT_THROW(task.result.get(), ProxyRequestAbortedError);
+}
+
+} //proxy
@@ -0,0 +1,104 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "MockProxyVerifier.hpp"
+#include "ProxyHealthMonitor.hpp"
+
+#include <atomic>
+#include <thread>
+
+using std::chrono::milliseconds;
+using testing::_;
+
+namespace proxy {
+
+namespace {
+
+const std::string test_url{ "http://test.com" };
+const ProxyRecord proxy_a{ "http://a.com:8080", 8080, ProxyTypes::HTTP };
+const ProxyRecord proxy_b{ "http://b.com:8080", 8080, ProxyTypes::HTTP };
+
+//polls instead of sleeping a fixed time, background checks run whenever the monitor gets to them
+template<typename Condition>
+bool eventually(Condition condition)
+{
+   const auto giveUpAt = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+   while (!condition()) {
+      if (std::chrono::steady_clock::now() >= giveUpAt) {
+         return false;
+      }
+      std::this_thread::sleep_for(milliseconds(2));
+   }
+   return true;
+}
+
+} //namespace
+
+TEST(TestProxyHealthMonitor, discoveryResultsAreKept)
+{
+   auto verifier = std::make_shared<testing::NiceMock<MockProxyVerifier>>();
+   std::atomic<int> changes{ 0 };
+   ProxyHealthMonitor monitor{ verifier, std::chrono::hours(1), std::chrono::hours(1), 2, [&changes]() { ++changes; } };
+   EXPECT_FALSE(monitor.health(test_url, proxy_a));
+
+   monitor.track(test_url, { proxy_a, proxy_b }, { true, false });
+   EXPECT_EQ(monitor.size(), 2u);
+   EXPECT_EQ(monitor.health(test_url, proxy_a), true);
+   //one failure is not enough to skip the proxy
+   EXPECT_FALSE(monitor.health(test_url, proxy_b));
+   EXPECT_FALSE(monitor.health("http://other.com", proxy_a));
+
+   monitor.track(test_url, { proxy_b }, { false });
+   EXPECT_EQ(monitor.size(), 1u);
+   EXPECT_EQ(monitor.health(test_url, proxy_b), false);
+   EXPECT_FALSE(monitor.health(test_url, proxy_a));
+   //discoveries report their own results
+   EXPECT_EQ(changes, 0);
+}
+
+TEST(TestProxyHealthMonitor, circuitOpensAndClosesWithChecks)
+{
+   auto verifier = std::make_shared<MockProxyVerifier>();
+   std::atomic<bool> working{ false };
+   std::atomic<int> changes{ 0 };
+   EXPECT_CALL(*verifier, verifyProxy(test_url, proxy_a)).WillRepeatedly([&working](const std::string&, const ProxyRecord&) {
+      return working.load();
+   });
+   ProxyHealthMonitor monitor{ verifier, milliseconds(5), milliseconds(10), 2, [&changes]() { ++changes; } };
+
+   monitor.track(test_url, { proxy_a }, { true });
+   ASSERT_TRUE(eventually([&]() { return monitor.health(test_url, proxy_a) == std::optional<bool>(false); }));
+   EXPECT_EQ(changes, 1);
+
+   working = true;
+   ASSERT_TRUE(eventually([&]() { return monitor.health(test_url, proxy_a) == std::optional<bool>(true); }));
+   ASSERT_TRUE(eventually([&]() { return changes == 2; }));
+   //passing checks of a working proxy change nothing
+   std::this_thread::sleep_for(milliseconds(30));
+   EXPECT_EQ(changes, 2);
+}
+
+TEST(TestProxyHealthMonitor, failingProxyIsCheckedLessOften)
+{
+   auto verifier = std::make_shared<MockProxyVerifier>();
+   std::atomic<int> checks{ 0 };
+   EXPECT_CALL(*verifier, verifyProxy(_, _)).WillRepeatedly([&checks](const std::string&, const ProxyRecord&) {
+      ++checks;
+      return false;
+   });
+   ProxyHealthMonitor monitor{ verifier, milliseconds(10), std::chrono::hours(1), 100, nullptr };
+
+   monitor.track(test_url, { proxy_a }, { false });
+   std::this_thread::sleep_for(milliseconds(300));
+   //every 10ms that would be 30 checks, doubling the delay from 10ms it is at most 5
+   EXPECT_GE(checks, 1);
+   EXPECT_LE(checks, 6);
+}
+
+} //proxy
@@ -0,0 +1,116 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "AsyncProxyLogger.h"
+#include "ProxyLoggerDef.hpp"
+
+#include <cstdio>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace proxy {
+
+namespace {
+
+class RecordingLogger : public IProxyLogger
+{
+public:
+   void Log( int severity, const char* msgFormatter, ... ) override
+   {
+      va_list args;
+      va_start(args, msgFormatter);
+      Log(severity, msgFormatter, args);
+      va_end(args);
+   }
+   void Log( int severity, const char* msgFormatter, va_list args ) override
+   {
+      if (blocker) {
+         blocker->wait();
+      }
+      char message[AsyncProxyLogger::maxMessageLength];
+      std::vsnprintf(message, sizeof(message), msgFormatter, args);
+      std::lock_guard<std::mutex> lock(mutex);
+      messages.emplace_back(std::to_string(severity) + " " + message);
+   }
+
+   std::mutex mutex;
+   std::vector<std::string> messages;
+   std::shared_future<void> *blocker = nullptr;
+};
+
+int evaluations = 0;
+
+int evaluated()
+{
+   return ++evaluations;
+}
+
+} //namespace
+
+TEST(TestProxyLogger, lessSevereMessagesAreNotFormatted)
+{
+   RecordingLogger logger;
+   SetProxyLogger(&logger);
+   SetProxyLogSeverity(4);
+   evaluations = 0;
+
+   PROXY_LOG_DEBUG("debug %d", evaluated());
+   PROXY_LOG_WARNING("warning %d", evaluated());
+   SetProxyLogSeverity(7);
+   SetProxyLogger(nullptr);
+
+   EXPECT_EQ(evaluations, 1);
+   ASSERT_EQ(logger.messages.size(), 1u);
+   EXPECT_THAT(logger.messages.front(), testing::StartsWith("4 TestProxyLogger.cpp:"));
+   EXPECT_THAT(logger.messages.front(), testing::EndsWith(": warning 1"));
+}
+
+TEST(TestProxyLogger, fileNameIsThePathAfterItsLastSlash)
+{
+   static_assert(std::string_view(proxyLogFileName("/src/linux/File.cpp")) == "File.cpp");
+   EXPECT_STREQ(proxyLogFileName("File.cpp"), "File.cpp");
+}
+
+TEST(TestAsyncProxyLogger, messagesReachTheLoggerInOrder)
+{
+   RecordingLogger logger;
+   {
+      AsyncProxyLogger async{ logger, 4 };
+      for (int i = 0; i < 3; ++i) {
+         async.Log(6, "message %d", i);
+         async.flush();
+      }
+      EXPECT_THAT(logger.messages, testing::ElementsAre("6 message 0", "6 message 1", "6 message 2"));
+      async.Log(3, "logged before destruction");
+   }
+   EXPECT_EQ(logger.messages.back(), "3 logged before destruction");
+}
+
+TEST(TestAsyncProxyLogger, fullBufferDropsInsteadOfBlocking)
+{
+   RecordingLogger logger;
+   std::promise<void> release;
+   std::shared_future<void> released = release.get_future().share();
+   logger.blocker = &released;
+   {
+      AsyncProxyLogger async{ logger, 2 };
+      //the message held up in the logger keeps its slot, so two fit and the rest are dropped
+      for (int i = 0; i < 10; ++i) {
+         async.Log(6, "message %d", i);
+      }
+      EXPECT_EQ(async.droppedCount(), 8u);
+      release.set_value();
+      async.flush();
+   }
+   ASSERT_EQ(logger.messages.size(), 2u);
+   EXPECT_EQ(logger.messages.front(), "6 message 0");
+}
+
+} //proxy
@@ -0,0 +1,100 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+
+#include "ProxyRecord.h"
+
+#include <string>
+#include <utility>
+
+namespace proxy {
+
+static_assert(proxyTypeName(ProxyTypes::HTTP) == "http", "type names are known at compile time");
+static_assert(proxyTypeName(ProxyTypes::None).empty(), "ProxyTypes::None has no name");
+
+ProxyRecord record(int i)
+{
+   return { "http://proxy" + std::to_string(i) + ".com:8080", 8080, ProxyTypes::HTTP };
+}
+
+TEST(TestProxyRecords, typeNames)
+{
+   EXPECT_EQ(ProxyRecord(record(0)).getProxyTypeName(), "http");
+   EXPECT_EQ(proxyTypeName(ProxyTypes::autoConfigurationURL), "autoConfigurationURL");
+   EXPECT_EQ(proxyTypeName(ProxyTypes::SOCKS), "socks");
+   EXPECT_EQ(proxyTypeName(static_cast<ProxyTypes>(100)), "");
+}
+
+TEST(TestProxyRecords, fewRecordsStayInPlace)
+{
+   ProxyRecords records;
+   for (int i = 0; i < 8; ++i) {
+      records.push_back(record(i));
+   }
+   EXPECT_TRUE(records.isInline());
+   EXPECT_EQ(records.size(), 8u);
+   EXPECT_EQ(records.back(), record(7));
+}
+
+TEST(TestProxyRecords, growsPastInlineCapacity)
+{
+   ProxyRecords records;
+   for (int i = 0; i < 20; ++i) {
+      records.push_back(record(i));
+   }
+   EXPECT_FALSE(records.isInline());
+   ASSERT_EQ(records.size(), 20u);
+   for (int i = 0; i < 20; ++i) {
+      EXPECT_EQ(records[i], record(i));
+   }
+}
+
+TEST(TestProxyRecords, pushBackOwnElementWhileGrowing)
+{
+   ProxyRecords records;
+   for (int i = 0; i < 8; ++i) {
+      records.push_back(record(i));
+   }
+   records.push_back(records.front());
+   EXPECT_EQ(records.back(), record(0));
+}
+
+TEST(TestProxyRecords, copyAndMove)
+{
+   for (const int count : { 3, 12 }) {
+      ProxyRecords records;
+      for (int i = 0; i < count; ++i) {
+         records.push_back(record(i));
+      }
+
+      ProxyRecords copied{ records };
+      EXPECT_EQ(copied, records);
+
+      ProxyRecords moved{ std::move(copied) };
+      EXPECT_EQ(moved, records);
+      EXPECT_TRUE(copied.empty());
+
+      ProxyRecords assigned{ record(100) };
+      assigned = moved;
+      EXPECT_EQ(assigned, records);
+      assigned = std::move(moved);
+      EXPECT_EQ(assigned, records);
+      EXPECT_TRUE(moved.empty());
+   }
+}
+
+TEST(TestProxyRecords, erase)
+{
+   ProxyRecords records{ record(0), record(1), record(2), record(3) };
+   auto next = records.erase(records.begin() + 1);
+   EXPECT_EQ(*next, record(2));
+   next = records.erase(records.begin(), records.begin() + 2);
+   EXPECT_EQ(next, records.begin());
+   EXPECT_EQ(records, ProxyRecords{ record(3) });
+}
+
+} //proxy
@@ -0,0 +1,83 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "ProxyTracer.hpp"
+
+#include <thread>
+
+using testing::HasSubstr;
+using testing::Not;
+
+namespace proxy {
+
+TEST(TestProxyTracer, nothingIsRecordedWithoutTrace)
+{
+   StartProxyTrace();
+   StopProxyTrace();
+   {
+      TraceSpan span("untraced");
+   }
+   EXPECT_EQ(ExportProxyTrace(), "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+}
+
+TEST(TestProxyTracer, spansAreTaggedWithTheRequest)
+{
+   StartProxyTrace();
+   const std::string guid{ "guid-1" };
+   {
+      TraceRequestScope scope(guid);
+      TraceSpan outer("outer", "with \"quotes\"");
+      TraceSpan inner("inner");
+   }
+   {
+      TraceSpan untagged("untagged");
+   }
+   StopProxyTrace();
+
+   const std::string trace = ExportProxyTrace();
+   EXPECT_THAT(trace, HasSubstr("\"name\":\"outer\",\"cat\":\"proxy\",\"ph\":\"X\""));
+   EXPECT_THAT(trace, HasSubstr("\"args\":{\"guid\":\"guid-1\",\"detail\":\"with \\\"quotes\\\"\"}"));
+   EXPECT_THAT(trace, HasSubstr("\"name\":\"inner\""));
+   EXPECT_THAT(trace, HasSubstr("\"args\":{\"guid\":\"\",\"detail\":\"\"}"));
+}
+
+TEST(TestProxyTracer, asyncSpansBeginAndEnd)
+{
+   StartProxyTrace();
+   std::thread([]() {
+      const auto now = std::chrono::steady_clock::now();
+      recordTraceSpan("probe", "http://proxy:3128", now - std::chrono::milliseconds(5), now, 42);
+   }).join();
+   StopProxyTrace();
+
+   //the spans of a finished thread are kept
+   const std::string trace = ExportProxyTrace();
+   EXPECT_THAT(trace, HasSubstr("\"name\":\"probe\",\"cat\":\"proxy\",\"ph\":\"b\""));
+   EXPECT_THAT(trace, HasSubstr("\"name\":\"probe\",\"cat\":\"proxy\",\"ph\":\"e\""));
+   EXPECT_THAT(trace, HasSubstr("\"id\":42"));
+}
+
+TEST(TestProxyTracer, newTraceDiscardsEarlierSpans)
+{
+   StartProxyTrace();
+   {
+      TraceSpan span("earlier");
+   }
+   StartProxyTrace();
+   {
+      TraceSpan span("later");
+   }
+   StopProxyTrace();
+
+   const std::string trace = ExportProxyTrace();
+   EXPECT_THAT(trace, Not(HasSubstr("earlier")));
+   EXPECT_THAT(trace, HasSubstr("later"));
+}
+
+} //proxy
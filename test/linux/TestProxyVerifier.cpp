@@ -0,0 +1,259 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "ProxyVerifier.hpp"
+#include "CancellationToken.hpp"
+#include "LocalHttpServer.hpp"
+#include "PrometheusProxyMetrics.h"
+#include "ProxyTracing.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace proxy {
+
+namespace {
+
+//accepts connections into its backlog and never answers, so transfers through it hang
+class SilentProxy
+{
+public:
+   SilentProxy()
+   {
+      fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      sockaddr_in address{};
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t length = sizeof(address);
+      bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+      listen(fd_, 16);
+      getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length);
+      port_ = ntohs(address.sin_port);
+   }
+
+   ~SilentProxy()
+   {
+      close(fd_);
+   }
+
+   ProxyRecord record() const
+   {
+      return { "http://127.0.0.1:" + std::to_string(port_), port_, ProxyTypes::HTTP };
+   }
+
+private:
+   int fd_ = -1;
+   uint16_t port_ = 0;
+};
+
+const std::string test_url{ "http://example.invalid/" };
+
+} //namespace
+
+TEST(TestProxyVerifier, cancelledRequestAbortsTransfers)
+{
+   SilentProxy proxy;
+   ProxyVerifier verifier{ std::chrono::seconds(30) };
+   CancellationToken token;
+   std::thread canceller([&token]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      token.cancel();
+   });
+
+   const auto start = std::chrono::steady_clock::now();
+   {
+      CancellationToken::Scope scope(&token);
+      EXPECT_THAT(verifier.verifyProxies(test_url, { proxy.record(), proxy.record() }), testing::ElementsAre(false, false));
+   }
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+   canceller.join();
+}
+
+TEST(TestProxyVerifier, cancelledRequestAbortsSingleVerification)
+{
+   SilentProxy proxy;
+   ProxyVerifier verifier{ std::chrono::seconds(30) };
+   CancellationToken token;
+   std::thread canceller([&token]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      token.cancel();
+   });
+
+   const auto start = std::chrono::steady_clock::now();
+   {
+      CancellationToken::Scope scope(&token);
+      EXPECT_FALSE(verifier.verifyProxy(test_url, proxy.record()));
+   }
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+   canceller.join();
+}
+
+TEST(TestProxyVerifier, requestDeadlineShortensTimeout)
+{
+   SilentProxy proxy;
+   ProxyVerifier verifier{ std::chrono::seconds(30) };
+   CancellationToken token{ CancellationToken::Clock::now() + std::chrono::milliseconds(100) };
+   CancellationToken::Scope scope(&token);
+
+   const auto start = std::chrono::steady_clock::now();
+   EXPECT_FALSE(verifier.verifyProxy(test_url, proxy.record()));
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(TestProxyVerifier, proxyHostIsPinnedToResolvedAddress)
+{
+   //answers the test request it is sent as a proxy
+   LocalHttpServer proxy{ [](const LocalHttpServer::Request&) { return LocalHttpServer::Response{}; } };
+   const std::string proxyPort = proxy.url("").substr(proxy.url("").rfind(':') + 1);
+   std::atomic<int> lookups{ 0 };
+   auto dnsCache = std::make_shared<DnsCache>(std::chrono::seconds(60), std::chrono::seconds(5), [&lookups](const std::string& host) {
+      ++lookups;
+      return host == "pinned.invalid" ? std::vector<std::string>{ "127.0.0.1" } : std::vector<std::string>{};
+   });
+   ProxyVerifier verifier{ std::chrono::seconds(5), dnsCache };
+
+   const ProxyRecord pinned{ "http://pinned.invalid:" + proxyPort, static_cast<uint32_t>(std::stoul(proxyPort)), ProxyTypes::HTTP };
+   EXPECT_THAT(verifier.verifyProxies(test_url, { pinned, pinned }), testing::ElementsAre(true, true));
+   EXPECT_TRUE(verifier.verifyProxy(test_url, pinned));
+   EXPECT_EQ(lookups, 1);
+}
+
+TEST(TestProxyVerifier, unresolvableProxyHostFailsWithoutTransfer)
+{
+   SilentProxy reachable;
+   auto dnsCache = std::make_shared<DnsCache>(std::chrono::seconds(60), std::chrono::seconds(5), [](const std::string&) {
+      return std::vector<std::string>{};
+   });
+   ProxyVerifier verifier{ std::chrono::milliseconds(200), dnsCache };
+
+   const ProxyRecord dead{ "http://dead.invalid:3128", 3128, ProxyTypes::HTTP };
+   const auto start = std::chrono::steady_clock::now();
+   EXPECT_FALSE(verifier.verifyProxy(test_url, dead));
+   EXPECT_THAT(verifier.verifyProxies(test_url, { dead, reachable.record() }), testing::ElementsAre(false, false));
+   EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+//a proxy record for a LocalHttpServer, which answers every request it is sent as a proxy
+ProxyRecord serverProxy(const LocalHttpServer& server)
+{
+   const std::string url = server.url("");
+   return { url, static_cast<uint32_t>(std::stoul(url.substr(url.rfind(':') + 1))), ProxyTypes::HTTP };
+}
+
+std::string requestMethod(LocalHttpServer& server)
+{
+   const auto requests = server.requests();
+   return requests.empty() ? "" : requests.front().method;
+}
+
+TEST(TestProxyVerifier, connectDepthOnlyReachesProxy)
+{
+   SilentProxy proxy;
+   EXPECT_TRUE(ProxyVerifier(std::chrono::seconds(5), nullptr, VerificationDepth::Connect).verifyProxy(test_url, proxy.record()));
+   EXPECT_FALSE(ProxyVerifier(std::chrono::milliseconds(200), nullptr, VerificationDepth::Head).verifyProxy(test_url, proxy.record()));
+}
+
+TEST(TestProxyVerifier, handshakeDepthOpensTunnel)
+{
+   LocalHttpServer proxy{ [](const LocalHttpServer::Request&) { return LocalHttpServer::Response{}; } };
+   ProxyVerifier verifier{ std::chrono::seconds(5), nullptr, VerificationDepth::Handshake };
+   EXPECT_THAT(verifier.verifyProxies(test_url, { serverProxy(proxy) }), testing::ElementsAre(true));
+   ASSERT_EQ(proxy.requests().size(), 1u);
+   EXPECT_EQ(requestMethod(proxy), "CONNECT");
+   EXPECT_EQ(proxy.requests().front().path, "example.invalid:80");
+}
+
+TEST(TestProxyVerifier, headDepthSkipsBody)
+{
+   LocalHttpServer proxy{ [](const LocalHttpServer::Request&) {
+      LocalHttpServer::Response response;
+      response.body = "body";
+      return response;
+   } };
+   ProxyVerifier verifier{ std::chrono::seconds(5), nullptr, VerificationDepth::Head };
+   EXPECT_TRUE(verifier.verifyProxy(test_url, serverProxy(proxy)));
+   EXPECT_EQ(requestMethod(proxy), "HEAD");
+}
+
+TEST(TestProxyVerifier, getDepthRequestsTestUrl)
+{
+   LocalHttpServer proxy{ [](const LocalHttpServer::Request&) {
+      LocalHttpServer::Response response;
+      response.body = "body";
+      return response;
+   } };
+   ProxyVerifier verifier{ std::chrono::seconds(5) };
+   EXPECT_TRUE(verifier.verifyProxy(test_url, serverProxy(proxy)));
+   EXPECT_EQ(requestMethod(proxy), "GET");
+   EXPECT_EQ(proxy.requests().front().path, test_url);
+}
+
+TEST(TestProxyVerifier, passedVerificationIsTimed)
+{
+   LocalHttpServer proxy{ [](const LocalHttpServer::Request&) {
+      LocalHttpServer::Response response;
+      response.delay = std::chrono::milliseconds(50);
+      return response;
+   } };
+   SilentProxy silent;
+   ProxyVerifier verifier{ std::chrono::milliseconds(500) };
+   EXPECT_THAT(verifier.verifyProxies(test_url, { serverProxy(proxy), silent.record() }), testing::ElementsAre(true, false));
+
+   const auto latency = verifier.latency(serverProxy(proxy));
+   ASSERT_TRUE(latency);
+   EXPECT_GE(latency->firstByte, std::chrono::milliseconds(50));
+   EXPECT_LE(latency->connect, latency->firstByte);
+   EXPECT_EQ(latency->score, latency->firstByte);
+   EXPECT_FALSE(verifier.latency(silent.record()));
+}
+
+TEST(TestProxyVerifier, verificationsAreCountedByResult)
+{
+   LocalHttpServer proxy{ [](const LocalHttpServer::Request&) { return LocalHttpServer::Response{}; } };
+   auto dnsCache = std::make_shared<DnsCache>(std::chrono::seconds(60), std::chrono::seconds(5), [](const std::string&) {
+      return std::vector<std::string>{};
+   });
+   ProxyVerifier verifier{ std::chrono::milliseconds(500), dnsCache };
+   //the address of the local server is not looked up, the dead host is
+   const ProxyRecord dead{ "http://dead.invalid:3128", 3128, ProxyTypes::HTTP };
+
+   PrometheusProxyMetrics metrics;
+   SetProxyMetrics(&metrics);
+   EXPECT_THAT(verifier.verifyProxies(test_url, { serverProxy(proxy), dead }), testing::ElementsAre(true, false));
+   SetProxyMetrics(nullptr);
+
+   const std::string rendered = metrics.render();
+   EXPECT_THAT(rendered, testing::HasSubstr("proxy_discovery_verifications_total{code=\"0\"} 1\n"));
+   EXPECT_THAT(rendered, testing::HasSubstr("proxy_discovery_verifications_total{code=\"unresolvable\"} 1\n"));
+   EXPECT_THAT(rendered, testing::HasSubstr("proxy_discovery_verification_seconds_count 1\n"));
+   EXPECT_THAT(rendered, testing::HasSubstr("proxy_discovery_cache_lookups_total{cache=\"dns\",result=\"miss\"} 1\n"));
+}
+
+TEST(TestProxyVerifier, probeIsTracedWithItsPhases)
+{
+   LocalHttpServer proxy{ [](const LocalHttpServer::Request&) { return LocalHttpServer::Response{}; } };
+   ProxyVerifier verifier{ std::chrono::milliseconds(500) };
+
+   StartProxyTrace();
+   EXPECT_TRUE(verifier.verifyProxy(test_url, serverProxy(proxy)));
+   StopProxyTrace();
+
+   const std::string trace = ExportProxyTrace();
+   EXPECT_THAT(trace, testing::HasSubstr("\"name\":\"probe\",\"cat\":\"proxy\",\"ph\":\"b\""));
+   EXPECT_THAT(trace, testing::HasSubstr("\"name\":\"dns\""));
+   EXPECT_THAT(trace, testing::HasSubstr("\"name\":\"connect\""));
+}
+
+} //proxy
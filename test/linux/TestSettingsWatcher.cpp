@@ -0,0 +1,97 @@
+/**
+ * @file
+ *
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved
+ */
+
+#include <gtest/gtest.h>
+
+#include "SettingsWatcher.hpp"
+
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sys/stat.h>
+
+namespace proxy {
+
+class TestSettingsWatcher : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      directory_ = testing::TempDir() + "/settings-watcher-" + std::to_string(getpid());
+      mkdir(directory_.c_str(), 0700);
+      file_ = directory_ + "/kioslaverc";
+      std::ofstream(file_) << "[Proxy Settings]\n";
+   }
+   void TearDown() override
+   {
+      std::remove(file_.c_str());
+      std::remove((directory_ + "/unrelated").c_str());
+      rmdir(directory_.c_str());
+   }
+
+   void onChange()
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++changes_;
+      changed_.notify_all();
+   }
+
+   bool waitForChanges(int count, std::chrono::milliseconds timeout)
+   {
+      std::unique_lock<std::mutex> lock(mutex_);
+      return changed_.wait_for(lock, timeout, [this, count]() { return changes_ >= count; });
+   }
+
+   std::string directory_;
+   std::string file_;
+   std::mutex mutex_;
+   std::condition_variable changed_;
+   int changes_ = 0;
+};
+
+TEST_F(TestSettingsWatcher, reportsWrites)
+{
+   SettingsWatcher watcher({ file_ }, [this]() { onChange(); }, std::chrono::milliseconds(20));
+   ASSERT_TRUE(watcher.isWatching());
+
+   std::ofstream(file_) << "[Proxy Settings]\nProxyType=1\n";
+   EXPECT_TRUE(waitForChanges(1, std::chrono::seconds(5)));
+}
+
+TEST_F(TestSettingsWatcher, reportsReplacementByRename)
+{
+   SettingsWatcher watcher({ file_ }, [this]() { onChange(); }, std::chrono::milliseconds(20));
+   ASSERT_TRUE(watcher.isWatching());
+
+   const std::string replacement{ directory_ + "/kioslaverc.new" };
+   std::ofstream(replacement) << "[Proxy Settings]\nProxyType=0\n";
+   ASSERT_EQ(std::rename(replacement.c_str(), file_.c_str()), 0);
+   EXPECT_TRUE(waitForChanges(1, std::chrono::seconds(5)));
+}
+
+TEST_F(TestSettingsWatcher, coalescesBurstsAndIgnoresOtherFiles)
+{
+   SettingsWatcher watcher({ file_ }, [this]() { onChange(); }, std::chrono::milliseconds(200));
+   ASSERT_TRUE(watcher.isWatching());
+
+   std::ofstream(directory_ + "/unrelated") << "x";
+   for (int i = 0; i < 5; ++i) {
+      std::ofstream(file_) << i;
+   }
+   EXPECT_TRUE(waitForChanges(1, std::chrono::seconds(5)));
+   std::this_thread::sleep_for(std::chrono::milliseconds(400));
+   std::lock_guard<std::mutex> lock(mutex_);
+   EXPECT_EQ(changes_, 1);
+}
+
+TEST_F(TestSettingsWatcher, missingDirectoryIsNotWatched)
+{
+   SettingsWatcher watcher({ directory_ + "/missing/user" }, [this]() { onChange(); });
+   EXPECT_FALSE(watcher.isWatching());
+}
+
+} //proxy
@@ -0,0 +1,18 @@
+/**
+ * @file
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved.
+ */
+#pragma once
+
+#include "IPacFetcher.hpp"
+#include "gmock/gmock.h"
+
+namespace proxy {
+
+class MockPacFetcher : public IPacFetcher
+{
+    public:
+        MOCK_METHOD(std::optional<std::string>, fetchScript, (const std::string &url), (override));
+};
+
+} //proxy
@@ -0,0 +1,24 @@
+/**
+ * @file
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved.
+ */
+#pragma once
+
+#include "IPacScriptRuntime.hpp"
+#include "gmock/gmock.h"
+
+namespace proxy {
+
+class MockPacScript : public IPacScript
+{
+    public:
+        MOCK_METHOD(std::optional<std::string>, findProxyForUrl, (const std::string &url, const std::string &host), (override));
+};
+
+class MockPacScriptRuntime : public IPacScriptRuntime
+{
+    public:
+        MOCK_METHOD(std::unique_ptr<IPacScript>, compile, (const std::string &script), (override));
+};
+
+} //proxy
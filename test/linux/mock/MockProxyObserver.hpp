@@ -0,0 +1,19 @@
+/**
+ * @file
+ * @copyright (c) 2025 Cisco Systems, Inc. All rights reserved.
+ */
+#pragma once
+
+#include "IProxyDiscoveryEngine.h"
+#include "gmock/gmock.h"
+
+namespace proxy {
+
+class MockProxyObserver : public IProxyObserver
+{
+    public:
+        MOCK_METHOD(void, updateProxyList, (const std::list<ProxyRecord>& proxies, const std::string& guid), (override));
+        MOCK_METHOD(void, proxyRequestAborted, (const std::string& guid, ProxyRequestOutcome outcome), (override));
+};
+
+} //proxy
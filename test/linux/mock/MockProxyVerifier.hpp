@@ -13,6 +13,8 @@ class MockProxyVerifier : public IProxyVerifier
 {
     public:
         MOCK_METHOD(bool, verifyProxy, (const std::string &testUrl, const ProxyRecord &proxyRecord), (override));
+        MOCK_METHOD(std::optional<ProxyLatency>, latency, (const ProxyRecord &proxyRecord), (override));
+        MOCK_METHOD(void, invalidate, (), (override));
 };
 
 } //proxy
\ No newline at end of file